@@ -0,0 +1,61 @@
+#include<atomic>
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+
+namespace{
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+
+void* allocate(std::size_t size){
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if(size == 0)
+    size = 1;
+  if(void* p = std::malloc(size))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void* allocate(std::size_t size, std::align_val_t align){
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  const auto alignment = static_cast<std::size_t>(align);
+  if(void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    return p;
+  throw std::bad_alloc{};
+}
+
+}
+
+namespace messer::micro{
+
+std::size_t allocation_count(){
+  return allocations.load(std::memory_order_relaxed);
+}
+
+}
+
+namespace{
+
+struct reporter{
+  ~reporter(){
+    const char* path = std::getenv("MESSER_ALLOC_STATS");
+    if(path == nullptr)
+      return;
+    if(auto fp = std::fopen(path, "w")){
+      std::fprintf(fp, "%zu %zu\n", allocations.load(), allocated_bytes.load());
+      std::fclose(fp);
+    }
+  }
+}report;
+
+}
+
+void* operator new(std::size_t size){return allocate(size);}
+void* operator new(std::size_t size, std::align_val_t align){return allocate(size, align);}
+void operator delete(void* p)noexcept{std::free(p);}
+void operator delete(void* p, std::align_val_t)noexcept{std::free(p);}
+void operator delete(void* p, std::size_t)noexcept{std::free(p);}
+void operator delete(void* p, std::size_t, std::align_val_t)noexcept{std::free(p);}
@@ -0,0 +1 @@
+#include<boost/preprocessor.hpp>
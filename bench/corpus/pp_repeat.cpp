@@ -0,0 +1,9 @@
+#include<boost/preprocessor/cat.hpp>
+#include<boost/preprocessor/repetition/repeat.hpp>
+#include<boost/preprocessor/repetition/enum_params.hpp>
+
+#define DECL(z, n, data) int BOOST_PP_CAT(data, n);
+#define FUNC(z, n, data) void BOOST_PP_CAT(data, n)(BOOST_PP_ENUM_PARAMS_Z(z, n, int a));
+
+BOOST_PP_REPEAT(200, DECL, var)
+BOOST_PP_REPEAT(64, FUNC, func)
@@ -0,0 +1,13 @@
+#include<boost/preprocessor/arithmetic/dec.hpp>
+#include<boost/preprocessor/arithmetic/add.hpp>
+#include<boost/preprocessor/control/while.hpp>
+#include<boost/preprocessor/tuple/elem.hpp>
+
+#define PRED(d, state) BOOST_PP_TUPLE_ELEM(2, 0, state)
+#define OP(d, state) (BOOST_PP_DEC(BOOST_PP_TUPLE_ELEM(2, 0, state)), BOOST_PP_ADD_D(d, BOOST_PP_TUPLE_ELEM(2, 1, state), 2))
+#define SUM(n) BOOST_PP_TUPLE_ELEM(2, 1, BOOST_PP_WHILE(PRED, OP, (n, 0)))
+
+int a = SUM(10);
+int b = SUM(50);
+int c = SUM(100);
+int d = SUM(120);
@@ -0,0 +1,32 @@
+#define F(x) x
+#define G F
+#define H(x) G
+#define PAIR(a, b) { a, b }
+#define APPLY(m, x) m(x)
+#define ID(x) x
+
+int a0 = G
+(1);
+int a1 = H(0)
+(2);
+int a2 = APPLY(
+  F,
+  3
+);
+int a3[] = PAIR
+(
+  4,
+  5
+);
+int a4 = ID(G)
+(6);
+int a5 = G (7) + G
+(8);
+int a6 = F
+(
+  G
+  (9)
+);
+int a7 = G;
+int a8 = ID(ID(ID(ID(G))))
+(10);
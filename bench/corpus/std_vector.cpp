@@ -0,0 +1 @@
+#include<vector>
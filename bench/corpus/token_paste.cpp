@@ -0,0 +1,17 @@
+#define CAT(a, b) CAT_I(a, b)
+#define CAT_I(a, b) a ## b
+#define C1(x) CAT(CAT(x, _), a)
+#define C2(x) C1(C1(x))
+#define C3(x) C2(C2(x))
+#define C4(x) C3(C3(x))
+#define C5(x) C4(C4(x))
+#define C6(x) C5(C5(x))
+
+int C6(p0);
+int C6(p1);
+int C6(p2);
+int C6(p3);
+int C6(p4);
+int C6(p5);
+int C6(p6);
+int C6(p7);
@@ -0,0 +1,411 @@
+#define TABLE(X) \
+  X(item_000, 0, "item 000") \
+  X(item_001, 1, "item 001") \
+  X(item_002, 2, "item 002") \
+  X(item_003, 3, "item 003") \
+  X(item_004, 4, "item 004") \
+  X(item_005, 5, "item 005") \
+  X(item_006, 6, "item 006") \
+  X(item_007, 7, "item 007") \
+  X(item_008, 8, "item 008") \
+  X(item_009, 9, "item 009") \
+  X(item_010, 10, "item 010") \
+  X(item_011, 11, "item 011") \
+  X(item_012, 12, "item 012") \
+  X(item_013, 13, "item 013") \
+  X(item_014, 14, "item 014") \
+  X(item_015, 15, "item 015") \
+  X(item_016, 16, "item 016") \
+  X(item_017, 17, "item 017") \
+  X(item_018, 18, "item 018") \
+  X(item_019, 19, "item 019") \
+  X(item_020, 20, "item 020") \
+  X(item_021, 21, "item 021") \
+  X(item_022, 22, "item 022") \
+  X(item_023, 23, "item 023") \
+  X(item_024, 24, "item 024") \
+  X(item_025, 25, "item 025") \
+  X(item_026, 26, "item 026") \
+  X(item_027, 27, "item 027") \
+  X(item_028, 28, "item 028") \
+  X(item_029, 29, "item 029") \
+  X(item_030, 30, "item 030") \
+  X(item_031, 31, "item 031") \
+  X(item_032, 32, "item 032") \
+  X(item_033, 33, "item 033") \
+  X(item_034, 34, "item 034") \
+  X(item_035, 35, "item 035") \
+  X(item_036, 36, "item 036") \
+  X(item_037, 37, "item 037") \
+  X(item_038, 38, "item 038") \
+  X(item_039, 39, "item 039") \
+  X(item_040, 40, "item 040") \
+  X(item_041, 41, "item 041") \
+  X(item_042, 42, "item 042") \
+  X(item_043, 43, "item 043") \
+  X(item_044, 44, "item 044") \
+  X(item_045, 45, "item 045") \
+  X(item_046, 46, "item 046") \
+  X(item_047, 47, "item 047") \
+  X(item_048, 48, "item 048") \
+  X(item_049, 49, "item 049") \
+  X(item_050, 50, "item 050") \
+  X(item_051, 51, "item 051") \
+  X(item_052, 52, "item 052") \
+  X(item_053, 53, "item 053") \
+  X(item_054, 54, "item 054") \
+  X(item_055, 55, "item 055") \
+  X(item_056, 56, "item 056") \
+  X(item_057, 57, "item 057") \
+  X(item_058, 58, "item 058") \
+  X(item_059, 59, "item 059") \
+  X(item_060, 60, "item 060") \
+  X(item_061, 61, "item 061") \
+  X(item_062, 62, "item 062") \
+  X(item_063, 63, "item 063") \
+  X(item_064, 64, "item 064") \
+  X(item_065, 65, "item 065") \
+  X(item_066, 66, "item 066") \
+  X(item_067, 67, "item 067") \
+  X(item_068, 68, "item 068") \
+  X(item_069, 69, "item 069") \
+  X(item_070, 70, "item 070") \
+  X(item_071, 71, "item 071") \
+  X(item_072, 72, "item 072") \
+  X(item_073, 73, "item 073") \
+  X(item_074, 74, "item 074") \
+  X(item_075, 75, "item 075") \
+  X(item_076, 76, "item 076") \
+  X(item_077, 77, "item 077") \
+  X(item_078, 78, "item 078") \
+  X(item_079, 79, "item 079") \
+  X(item_080, 80, "item 080") \
+  X(item_081, 81, "item 081") \
+  X(item_082, 82, "item 082") \
+  X(item_083, 83, "item 083") \
+  X(item_084, 84, "item 084") \
+  X(item_085, 85, "item 085") \
+  X(item_086, 86, "item 086") \
+  X(item_087, 87, "item 087") \
+  X(item_088, 88, "item 088") \
+  X(item_089, 89, "item 089") \
+  X(item_090, 90, "item 090") \
+  X(item_091, 91, "item 091") \
+  X(item_092, 92, "item 092") \
+  X(item_093, 93, "item 093") \
+  X(item_094, 94, "item 094") \
+  X(item_095, 95, "item 095") \
+  X(item_096, 96, "item 096") \
+  X(item_097, 97, "item 097") \
+  X(item_098, 98, "item 098") \
+  X(item_099, 99, "item 099") \
+  X(item_100, 100, "item 100") \
+  X(item_101, 101, "item 101") \
+  X(item_102, 102, "item 102") \
+  X(item_103, 103, "item 103") \
+  X(item_104, 104, "item 104") \
+  X(item_105, 105, "item 105") \
+  X(item_106, 106, "item 106") \
+  X(item_107, 107, "item 107") \
+  X(item_108, 108, "item 108") \
+  X(item_109, 109, "item 109") \
+  X(item_110, 110, "item 110") \
+  X(item_111, 111, "item 111") \
+  X(item_112, 112, "item 112") \
+  X(item_113, 113, "item 113") \
+  X(item_114, 114, "item 114") \
+  X(item_115, 115, "item 115") \
+  X(item_116, 116, "item 116") \
+  X(item_117, 117, "item 117") \
+  X(item_118, 118, "item 118") \
+  X(item_119, 119, "item 119") \
+  X(item_120, 120, "item 120") \
+  X(item_121, 121, "item 121") \
+  X(item_122, 122, "item 122") \
+  X(item_123, 123, "item 123") \
+  X(item_124, 124, "item 124") \
+  X(item_125, 125, "item 125") \
+  X(item_126, 126, "item 126") \
+  X(item_127, 127, "item 127") \
+  X(item_128, 128, "item 128") \
+  X(item_129, 129, "item 129") \
+  X(item_130, 130, "item 130") \
+  X(item_131, 131, "item 131") \
+  X(item_132, 132, "item 132") \
+  X(item_133, 133, "item 133") \
+  X(item_134, 134, "item 134") \
+  X(item_135, 135, "item 135") \
+  X(item_136, 136, "item 136") \
+  X(item_137, 137, "item 137") \
+  X(item_138, 138, "item 138") \
+  X(item_139, 139, "item 139") \
+  X(item_140, 140, "item 140") \
+  X(item_141, 141, "item 141") \
+  X(item_142, 142, "item 142") \
+  X(item_143, 143, "item 143") \
+  X(item_144, 144, "item 144") \
+  X(item_145, 145, "item 145") \
+  X(item_146, 146, "item 146") \
+  X(item_147, 147, "item 147") \
+  X(item_148, 148, "item 148") \
+  X(item_149, 149, "item 149") \
+  X(item_150, 150, "item 150") \
+  X(item_151, 151, "item 151") \
+  X(item_152, 152, "item 152") \
+  X(item_153, 153, "item 153") \
+  X(item_154, 154, "item 154") \
+  X(item_155, 155, "item 155") \
+  X(item_156, 156, "item 156") \
+  X(item_157, 157, "item 157") \
+  X(item_158, 158, "item 158") \
+  X(item_159, 159, "item 159") \
+  X(item_160, 160, "item 160") \
+  X(item_161, 161, "item 161") \
+  X(item_162, 162, "item 162") \
+  X(item_163, 163, "item 163") \
+  X(item_164, 164, "item 164") \
+  X(item_165, 165, "item 165") \
+  X(item_166, 166, "item 166") \
+  X(item_167, 167, "item 167") \
+  X(item_168, 168, "item 168") \
+  X(item_169, 169, "item 169") \
+  X(item_170, 170, "item 170") \
+  X(item_171, 171, "item 171") \
+  X(item_172, 172, "item 172") \
+  X(item_173, 173, "item 173") \
+  X(item_174, 174, "item 174") \
+  X(item_175, 175, "item 175") \
+  X(item_176, 176, "item 176") \
+  X(item_177, 177, "item 177") \
+  X(item_178, 178, "item 178") \
+  X(item_179, 179, "item 179") \
+  X(item_180, 180, "item 180") \
+  X(item_181, 181, "item 181") \
+  X(item_182, 182, "item 182") \
+  X(item_183, 183, "item 183") \
+  X(item_184, 184, "item 184") \
+  X(item_185, 185, "item 185") \
+  X(item_186, 186, "item 186") \
+  X(item_187, 187, "item 187") \
+  X(item_188, 188, "item 188") \
+  X(item_189, 189, "item 189") \
+  X(item_190, 190, "item 190") \
+  X(item_191, 191, "item 191") \
+  X(item_192, 192, "item 192") \
+  X(item_193, 193, "item 193") \
+  X(item_194, 194, "item 194") \
+  X(item_195, 195, "item 195") \
+  X(item_196, 196, "item 196") \
+  X(item_197, 197, "item 197") \
+  X(item_198, 198, "item 198") \
+  X(item_199, 199, "item 199") \
+  X(item_200, 200, "item 200") \
+  X(item_201, 201, "item 201") \
+  X(item_202, 202, "item 202") \
+  X(item_203, 203, "item 203") \
+  X(item_204, 204, "item 204") \
+  X(item_205, 205, "item 205") \
+  X(item_206, 206, "item 206") \
+  X(item_207, 207, "item 207") \
+  X(item_208, 208, "item 208") \
+  X(item_209, 209, "item 209") \
+  X(item_210, 210, "item 210") \
+  X(item_211, 211, "item 211") \
+  X(item_212, 212, "item 212") \
+  X(item_213, 213, "item 213") \
+  X(item_214, 214, "item 214") \
+  X(item_215, 215, "item 215") \
+  X(item_216, 216, "item 216") \
+  X(item_217, 217, "item 217") \
+  X(item_218, 218, "item 218") \
+  X(item_219, 219, "item 219") \
+  X(item_220, 220, "item 220") \
+  X(item_221, 221, "item 221") \
+  X(item_222, 222, "item 222") \
+  X(item_223, 223, "item 223") \
+  X(item_224, 224, "item 224") \
+  X(item_225, 225, "item 225") \
+  X(item_226, 226, "item 226") \
+  X(item_227, 227, "item 227") \
+  X(item_228, 228, "item 228") \
+  X(item_229, 229, "item 229") \
+  X(item_230, 230, "item 230") \
+  X(item_231, 231, "item 231") \
+  X(item_232, 232, "item 232") \
+  X(item_233, 233, "item 233") \
+  X(item_234, 234, "item 234") \
+  X(item_235, 235, "item 235") \
+  X(item_236, 236, "item 236") \
+  X(item_237, 237, "item 237") \
+  X(item_238, 238, "item 238") \
+  X(item_239, 239, "item 239") \
+  X(item_240, 240, "item 240") \
+  X(item_241, 241, "item 241") \
+  X(item_242, 242, "item 242") \
+  X(item_243, 243, "item 243") \
+  X(item_244, 244, "item 244") \
+  X(item_245, 245, "item 245") \
+  X(item_246, 246, "item 246") \
+  X(item_247, 247, "item 247") \
+  X(item_248, 248, "item 248") \
+  X(item_249, 249, "item 249") \
+  X(item_250, 250, "item 250") \
+  X(item_251, 251, "item 251") \
+  X(item_252, 252, "item 252") \
+  X(item_253, 253, "item 253") \
+  X(item_254, 254, "item 254") \
+  X(item_255, 255, "item 255") \
+  X(item_256, 256, "item 256") \
+  X(item_257, 257, "item 257") \
+  X(item_258, 258, "item 258") \
+  X(item_259, 259, "item 259") \
+  X(item_260, 260, "item 260") \
+  X(item_261, 261, "item 261") \
+  X(item_262, 262, "item 262") \
+  X(item_263, 263, "item 263") \
+  X(item_264, 264, "item 264") \
+  X(item_265, 265, "item 265") \
+  X(item_266, 266, "item 266") \
+  X(item_267, 267, "item 267") \
+  X(item_268, 268, "item 268") \
+  X(item_269, 269, "item 269") \
+  X(item_270, 270, "item 270") \
+  X(item_271, 271, "item 271") \
+  X(item_272, 272, "item 272") \
+  X(item_273, 273, "item 273") \
+  X(item_274, 274, "item 274") \
+  X(item_275, 275, "item 275") \
+  X(item_276, 276, "item 276") \
+  X(item_277, 277, "item 277") \
+  X(item_278, 278, "item 278") \
+  X(item_279, 279, "item 279") \
+  X(item_280, 280, "item 280") \
+  X(item_281, 281, "item 281") \
+  X(item_282, 282, "item 282") \
+  X(item_283, 283, "item 283") \
+  X(item_284, 284, "item 284") \
+  X(item_285, 285, "item 285") \
+  X(item_286, 286, "item 286") \
+  X(item_287, 287, "item 287") \
+  X(item_288, 288, "item 288") \
+  X(item_289, 289, "item 289") \
+  X(item_290, 290, "item 290") \
+  X(item_291, 291, "item 291") \
+  X(item_292, 292, "item 292") \
+  X(item_293, 293, "item 293") \
+  X(item_294, 294, "item 294") \
+  X(item_295, 295, "item 295") \
+  X(item_296, 296, "item 296") \
+  X(item_297, 297, "item 297") \
+  X(item_298, 298, "item 298") \
+  X(item_299, 299, "item 299") \
+  X(item_300, 300, "item 300") \
+  X(item_301, 301, "item 301") \
+  X(item_302, 302, "item 302") \
+  X(item_303, 303, "item 303") \
+  X(item_304, 304, "item 304") \
+  X(item_305, 305, "item 305") \
+  X(item_306, 306, "item 306") \
+  X(item_307, 307, "item 307") \
+  X(item_308, 308, "item 308") \
+  X(item_309, 309, "item 309") \
+  X(item_310, 310, "item 310") \
+  X(item_311, 311, "item 311") \
+  X(item_312, 312, "item 312") \
+  X(item_313, 313, "item 313") \
+  X(item_314, 314, "item 314") \
+  X(item_315, 315, "item 315") \
+  X(item_316, 316, "item 316") \
+  X(item_317, 317, "item 317") \
+  X(item_318, 318, "item 318") \
+  X(item_319, 319, "item 319") \
+  X(item_320, 320, "item 320") \
+  X(item_321, 321, "item 321") \
+  X(item_322, 322, "item 322") \
+  X(item_323, 323, "item 323") \
+  X(item_324, 324, "item 324") \
+  X(item_325, 325, "item 325") \
+  X(item_326, 326, "item 326") \
+  X(item_327, 327, "item 327") \
+  X(item_328, 328, "item 328") \
+  X(item_329, 329, "item 329") \
+  X(item_330, 330, "item 330") \
+  X(item_331, 331, "item 331") \
+  X(item_332, 332, "item 332") \
+  X(item_333, 333, "item 333") \
+  X(item_334, 334, "item 334") \
+  X(item_335, 335, "item 335") \
+  X(item_336, 336, "item 336") \
+  X(item_337, 337, "item 337") \
+  X(item_338, 338, "item 338") \
+  X(item_339, 339, "item 339") \
+  X(item_340, 340, "item 340") \
+  X(item_341, 341, "item 341") \
+  X(item_342, 342, "item 342") \
+  X(item_343, 343, "item 343") \
+  X(item_344, 344, "item 344") \
+  X(item_345, 345, "item 345") \
+  X(item_346, 346, "item 346") \
+  X(item_347, 347, "item 347") \
+  X(item_348, 348, "item 348") \
+  X(item_349, 349, "item 349") \
+  X(item_350, 350, "item 350") \
+  X(item_351, 351, "item 351") \
+  X(item_352, 352, "item 352") \
+  X(item_353, 353, "item 353") \
+  X(item_354, 354, "item 354") \
+  X(item_355, 355, "item 355") \
+  X(item_356, 356, "item 356") \
+  X(item_357, 357, "item 357") \
+  X(item_358, 358, "item 358") \
+  X(item_359, 359, "item 359") \
+  X(item_360, 360, "item 360") \
+  X(item_361, 361, "item 361") \
+  X(item_362, 362, "item 362") \
+  X(item_363, 363, "item 363") \
+  X(item_364, 364, "item 364") \
+  X(item_365, 365, "item 365") \
+  X(item_366, 366, "item 366") \
+  X(item_367, 367, "item 367") \
+  X(item_368, 368, "item 368") \
+  X(item_369, 369, "item 369") \
+  X(item_370, 370, "item 370") \
+  X(item_371, 371, "item 371") \
+  X(item_372, 372, "item 372") \
+  X(item_373, 373, "item 373") \
+  X(item_374, 374, "item 374") \
+  X(item_375, 375, "item 375") \
+  X(item_376, 376, "item 376") \
+  X(item_377, 377, "item 377") \
+  X(item_378, 378, "item 378") \
+  X(item_379, 379, "item 379") \
+  X(item_380, 380, "item 380") \
+  X(item_381, 381, "item 381") \
+  X(item_382, 382, "item 382") \
+  X(item_383, 383, "item 383") \
+  X(item_384, 384, "item 384") \
+  X(item_385, 385, "item 385") \
+  X(item_386, 386, "item 386") \
+  X(item_387, 387, "item 387") \
+  X(item_388, 388, "item 388") \
+  X(item_389, 389, "item 389") \
+  X(item_390, 390, "item 390") \
+  X(item_391, 391, "item 391") \
+  X(item_392, 392, "item 392") \
+  X(item_393, 393, "item 393") \
+  X(item_394, 394, "item 394") \
+  X(item_395, 395, "item 395") \
+  X(item_396, 396, "item 396") \
+  X(item_397, 397, "item 397") \
+  X(item_398, 398, "item 398") \
+  X(item_399, 399, "item 399") 
+
+#define AS_ENUM(name, value, text) name = value,
+#define AS_STRING(name, value, text) text,
+#define AS_CASE(name, value, text) case name: return text;
+#define AS_COUNT(name, value, text) + 1
+
+enum items{ TABLE(AS_ENUM) };
+static const char* const item_names[] = { TABLE(AS_STRING) };
+inline const char* to_string(items i){ switch(i){ TABLE(AS_CASE) } return ""; }
+static constexpr int item_count = 0 TABLE(AS_COUNT);
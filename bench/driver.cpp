@@ -0,0 +1,314 @@
+#include<algorithm>
+#include<cctype>
+#include<cerrno>
+#include<chrono>
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<filesystem>
+#include<fstream>
+#include<iomanip>
+#include<iostream>
+#include<map>
+#include<optional>
+#include<set>
+#include<sstream>
+#include<stdexcept>
+#include<string>
+#include<string_view>
+#include<vector>
+
+#include<fcntl.h>
+#include<sys/resource.h>
+#include<sys/wait.h>
+#include<unistd.h>
+
+namespace{
+
+struct measurement{
+  std::chrono::duration<double> wall;
+  long peak_rss_kb;
+  std::size_t tokens;
+  std::optional<std::size_t> allocations;
+  std::optional<std::size_t> allocated_bytes;
+  bool succeeded;
+  std::string output;
+};
+
+std::vector<std::string> split_command(std::string_view cmd){
+  std::vector<std::string> ret;
+  std::istringstream iss{std::string{cmd}};
+  for(std::string x; iss >> x;)
+    ret.emplace_back(std::move(x));
+  return ret;
+}
+
+std::vector<std::string_view> split_tokens(std::string_view s){
+  std::vector<std::string_view> ret;
+  for(std::size_t i = 0; i < s.size();){
+    const unsigned char c = s[i];
+    if(std::isspace(c)){
+      ++i;
+      continue;
+    }
+    const auto first = i;
+    if(std::isalnum(c) || c == '_' || c == '.'){
+      while(i < s.size() && (std::isalnum(static_cast<unsigned char>(s[i])) || s[i] == '_' || s[i] == '.'))
+        ++i;
+    }
+    else if(c == '"' || c == '\''){
+      ++i;
+      while(i < s.size() && s[i] != c && s[i] != '\n')
+        i += s[i] == '\\' ? 2 : 1;
+      ++i;
+    }
+    else
+      ++i;
+    ret.emplace_back(s.substr(first, std::min(i, s.size()) - first));
+  }
+  return ret;
+}
+
+std::size_t count_tokens(std::string_view s){
+  return split_tokens(s).size();
+}
+
+measurement run(const std::vector<std::string>& command, const std::filesystem::path& alloc_stats){
+  int out[2];
+  if(pipe(out) != 0)
+    throw std::runtime_error("pipe failed");
+  std::filesystem::remove(alloc_stats);
+  const auto start = std::chrono::steady_clock::now();
+  const pid_t pid = fork();
+  if(pid < 0)
+    throw std::runtime_error("fork failed");
+  if(pid == 0){
+    dup2(out[1], STDOUT_FILENO);
+    close(out[0]);
+    close(out[1]);
+    const int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDERR_FILENO);
+    setenv("MESSER_ALLOC_STATS", alloc_stats.c_str(), 1);
+    std::vector<char*> argv;
+    for(auto&& x : command)
+      argv.push_back(const_cast<char*>(x.c_str()));
+    argv.push_back(nullptr);
+    execvp(argv[0], argv.data());
+    _exit(127);
+  }
+  close(out[1]);
+  std::string output;
+  char buf[1 << 16];
+  for(ssize_t n; (n = read(out[0], buf, sizeof(buf))) != 0;)
+    if(n > 0)
+      output.append(buf, n);
+    else if(errno != EINTR)
+      break;
+  close(out[0]);
+  int status;
+  rusage usage;
+  wait4(pid, &status, 0, &usage);
+  measurement m{std::chrono::steady_clock::now() - start, usage.ru_maxrss, count_tokens(output), std::nullopt, std::nullopt, WIFEXITED(status) && WEXITSTATUS(status) == 0, std::move(output)};
+  if(std::ifstream ifs{alloc_stats}){
+    std::size_t allocations, bytes;
+    if(ifs >> allocations >> bytes)
+      m.allocations = allocations, m.allocated_bytes = bytes;
+  }
+  return m;
+}
+
+measurement best_of(const std::vector<std::string>& command, const std::filesystem::path& alloc_stats, int repeat){
+  auto best = run(command, alloc_stats);
+  for(int i = 1; i < repeat; ++i){
+    auto m = run(command, alloc_stats);
+    if(m.wall < best.wall)
+      best = m;
+  }
+  return best;
+}
+
+// expands lines of n distinct invocations and checks that the time grows linearly with n
+int scaling(const std::string& messer, const std::filesystem::path& tmp, int repeat){
+  std::cout << std::right << std::setw(14) << "invocations" << std::setw(12) << "wall(ms)" << std::setw(16) << "ns/invocation" << '\n';
+  std::cout << std::fixed << std::setprecision(2);
+  std::vector<double> walls;
+  for(std::size_t n = 2000; n <= 32000; n *= 2){
+    const auto file = tmp / ("scaling-" + std::to_string(n) + ".cpp");
+    {
+      std::ofstream ofs{file};
+      ofs << "#define F(x) G(x, ) x\n"
+             "#define G(x, y) x ## y\n";
+      for(std::size_t i = 0; i < n; ++i)
+        ofs << "F(a" << i << ") ";
+      ofs << '\n';
+    }
+    auto command = split_command(messer);
+    command.push_back(file.string());
+    const auto m = best_of(command, tmp / "alloc_stats", repeat);
+    if(!m.succeeded){
+      std::cerr << "messer failed on " << file << '\n';
+      return EXIT_FAILURE;
+    }
+    walls.push_back(std::chrono::duration<double, std::milli>(m.wall).count());
+    std::cout << std::setw(14) << n << std::setw(12) << walls.back() << std::setw(16) << walls.back() * 1e6 / n << '\n';
+  }
+  //doubling the invocations doubles the increment for linear growth and quadruples it for quadratic growth
+  //averaged over every doubling, so that the noise of one run does not decide
+  const auto n = walls.size();
+  const auto growth = std::pow(std::max(walls[n-1] - walls[n-2], 1e-3) / std::max(walls[1] - walls[0], 1e-3), 1. / (n - 2));
+  std::cout << "increment growth per doubling: " << growth << '\n';
+  if(growth > 2.5){
+    std::cerr << "expansion time grows faster than linearly\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// the files each Makefile rule in `rules` lists under `root`, by target
+std::map<std::string, std::set<std::filesystem::path>> parse_rules(std::string rules, const std::filesystem::path& root){
+  for(std::size_t i; (i = rules.find("\\\n")) != std::string::npos;)
+    rules.replace(i, 2, " ");
+  std::map<std::string, std::set<std::filesystem::path>> ret;
+  std::istringstream iss{rules};
+  for(std::string line; std::getline(iss, line);){
+    const auto colon = line.find(':');
+    if(colon == std::string::npos)
+      continue;
+    auto& deps = ret[line.substr(0, colon)];
+    std::istringstream words{line.substr(colon+1)};
+    for(std::string x; words >> x;){
+      const auto path = std::filesystem::weakly_canonical(x);
+      if(path.string().compare(0, root.string().size(), root.string()) == 0)
+        deps.emplace(path);
+    }
+  }
+  return ret;
+}
+
+// writes two sources sharing a guarded header and checks that `messer -M` lists the same files for each as `cpp -M`
+int dependencies(const std::string& messer, const std::string& cpp, const std::filesystem::path& tmp){
+  const auto root = std::filesystem::weakly_canonical(tmp / "dependencies");
+  std::filesystem::create_directories(root / "include");
+  const auto write = [&](const std::filesystem::path& path, std::string_view text){
+    std::ofstream{root / path} << text;
+  };
+  write("include/shared.hpp", "#ifndef SHARED_HPP\n#define SHARED_HPP\n#include \"detail.hpp\"\n#endif\n");
+  write("include/detail.hpp", "#pragma once\n#define DETAIL 1\n");
+  write("include/only_b.hpp", "#define ONLY_B 1\n");
+  write("a.cpp", "#include <shared.hpp>\n");
+  write("b.cpp", "#include <shared.hpp>\n#if DETAIL\n#include <only_b.hpp>\n#endif\n");
+  const std::string include = "-I" + (root / "include").string();
+  auto messer_command = split_command(messer);
+  messer_command.insert(messer_command.end(), {include, "-M", (root / "a.cpp").string(), (root / "b.cpp").string()});
+  const auto m = run(messer_command, tmp / "alloc_stats");
+  if(!m.succeeded){
+    std::cerr << "messer -M failed\n";
+    return EXIT_FAILURE;
+  }
+  std::string expected;
+  for(auto&& x : {"a.cpp", "b.cpp"}){
+    auto cpp_command = split_command(cpp);
+    cpp_command.insert(cpp_command.end(), {include, "-M", (root / x).string()});
+    const auto r = run(cpp_command, tmp / "alloc_stats");
+    if(!r.succeeded){
+      std::cerr << "cpp -M failed\n";
+      return EXIT_FAILURE;
+    }
+    expected += r.output;
+  }
+  const auto actual = parse_rules(m.output, root);
+  if(actual != parse_rules(expected, root)){
+    std::cerr << "messer -M differs from cpp -M:\n" << m.output << "expected:\n" << expected;
+    return EXIT_FAILURE;
+  }
+  std::cout << "dependencies of " << actual.size() << " sources match cpp -M\n";
+  return EXIT_SUCCESS;
+}
+
+void usage(){
+  std::cerr << "usage: driver [--messer CMD] [--cpp CMD] [--repeat N] [--scaling] [--dependencies] [FILE...]\n";
+}
+
+}
+
+int main(int argc, char** argv){
+  std::string messer = "./bench/messer-bench";
+  std::string cpp = "cpp";
+  int repeat = 3;
+  bool check_scaling = false;
+  bool check_dependencies = false;
+  std::vector<std::filesystem::path> cases;
+  for(int i = 1; i < argc; ++i){
+    const std::string_view arg = argv[i];
+    if((arg == "--messer" || arg == "--cpp" || arg == "--repeat") && i+1 == argc){
+      usage();
+      return EXIT_FAILURE;
+    }
+    if(arg == "--messer")
+      messer = argv[++i];
+    else if(arg == "--cpp")
+      cpp = argv[++i];
+    else if(arg == "--repeat")
+      repeat = std::max(1, std::atoi(argv[++i]));
+    else if(arg == "--scaling")
+      check_scaling = true;
+    else if(arg == "--dependencies")
+      check_dependencies = true;
+    else if(arg.substr(0, 1) == "-"){
+      usage();
+      return EXIT_FAILURE;
+    }
+    else
+      cases.emplace_back(arg);
+  }
+  const auto tmp = std::filesystem::temp_directory_path() / ("messer-bench-" + std::to_string(getpid()));
+  std::filesystem::create_directories(tmp);
+  const auto alloc_stats = tmp / "alloc_stats";
+  if(check_scaling){
+    const auto status = scaling(messer, tmp, repeat);
+    std::filesystem::remove_all(tmp);
+    return status;
+  }
+  if(check_dependencies){
+    const auto status = dependencies(messer, cpp, tmp);
+    std::filesystem::remove_all(tmp);
+    return status;
+  }
+  std::cout << std::left << std::setw(28) << "case"
+            << std::right << std::setw(12) << "wall(ms)" << std::setw(14) << "tokens/s" << std::setw(12) << "rss(KiB)" << std::setw(12) << "allocs" << std::setw(14) << "alloc(KiB)"
+            << std::setw(12) << "cpp(ms)" << std::setw(12) << "cpp(KiB)" << std::setw(9) << "ratio" << '\n';
+  std::cout << std::fixed << std::setprecision(2);
+  int status = EXIT_SUCCESS;
+  for(auto&& c : cases){
+    auto messer_command = split_command(messer);
+    messer_command.push_back(c.string());
+    auto cpp_command = split_command(cpp);
+    cpp_command.insert(cpp_command.end(), {"-E", "-P", c.string()});
+    const auto m = best_of(messer_command, alloc_stats, repeat);
+    const auto r = best_of(cpp_command, alloc_stats, repeat);
+    const auto ms = [](auto d){return std::chrono::duration<double, std::milli>(d).count();};
+    std::cout << std::left << std::setw(28) << c.filename().string() << std::right
+              << std::setw(12) << ms(m.wall)
+              << std::setw(14) << (m.wall.count() > 0 ? m.tokens / m.wall.count() : 0.)
+              << std::setw(12) << m.peak_rss_kb;
+    if(m.allocations)
+      std::cout << std::setw(12) << *m.allocations << std::setw(14) << *m.allocated_bytes / 1024.;
+    else
+      std::cout << std::setw(12) << "-" << std::setw(14) << "-";
+    std::cout << std::setw(12) << ms(r.wall) << std::setw(12) << r.peak_rss_kb
+              << std::setw(9) << (r.wall.count() > 0 ? m.wall / r.wall : 0.)
+              << (m.succeeded ? "" : "  (messer failed)") << '\n';
+    if(!m.succeeded)
+      status = EXIT_FAILURE;
+    //streaming mode has to produce the same tokens however the invocations are split across lines
+    auto stream_command = split_command(messer);
+    stream_command.insert(stream_command.end(), {"--stream", c.string()});
+    const auto s = run(stream_command, alloc_stats);
+    if(m.succeeded && (!s.succeeded || split_tokens(s.output) != split_tokens(m.output))){
+      std::cerr << c.filename().string() << ": --stream output differs from batch output\n";
+      status = EXIT_FAILURE;
+    }
+  }
+  std::filesystem::remove_all(tmp);
+  return status;
+}
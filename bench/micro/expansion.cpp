@@ -0,0 +1,64 @@
+#include<messer/core.hpp>
+#include<bench/micro/micro.hpp>
+
+namespace{
+
+using messer::lex;
+using token_t = messer::phase4_t::token_t;
+
+std::string repeat(std::string_view s, int n){
+  std::string ret;
+  for(int i = 0; i < n; ++i)
+    ret += s;
+  return ret;
+}
+
+}
+
+int main(){
+  messer::phase4_t state;
+  const std::string prelude = R"(
+#define OBJ 42
+#define CHAIN0 CHAIN1
+#define CHAIN1 CHAIN2
+#define CHAIN2 CHAIN3
+#define CHAIN3 1
+#define ID(x) x
+#define ADD(a, b) ((a) + (b))
+#define TWICE(x) x x
+#define CAT(a, b) a ## b
+#define STR(x) #x
+#define NEST(x) ADD(ID(x), ID(x))
+)";
+  auto prelude_tokens = lex(prelude, "<prelude>");
+  state(prelude_tokens, std::filesystem::current_path(), std::cout);
+  //with `cold_pool`, the replaced nodes recycled by earlier iterations are released first
+  const auto expand = [&](std::string_view name, std::string_view invocation, bool cold_pool = false){
+    const auto source = repeat(invocation, 100);
+    const auto tokens = lex(source, "<bench>");
+    messer::micro::measure(name, [&]{
+      if(cold_pool)
+        state.pool = {};
+      std::list<token_t> line = tokens;
+      messer::phase4_t::pp_state pps{line, {}};
+      std::size_t n = 0;
+      for(auto it = line.cbegin(); it != line.cend();)
+        if(!messer::phase4_t::eval_macro(messer::phase4_t::eval_macro, [&n](auto&&){++n;return true;}, state, pps, it, line.cend(), messer::phase4_t::no_yield))
+          break;
+      messer::micro::do_not_optimize(n);
+    }, 100, "invocations");
+  };
+  messer::micro::measure("baseline: copy 100 invocations", [&, tokens = lex(repeat("ADD(1, 2) ", 100), "<bench>")]{
+    std::list<token_t> line = tokens;
+    messer::micro::do_not_optimize(line);
+  });
+  expand("object_macro_replace: OBJ", "OBJ ");
+  expand("object_macro_replace: 4-level chain", "CHAIN0 ");
+  expand("function-like: ID(a)", "ID(a) ");
+  expand("function-like: ADD(1, 2)", "ADD(1, 2) ");
+  expand("function-like: TWICE(ID(a))", "TWICE(ID(a)) ");
+  expand("function-like: CAT(a, b)", "CAT(a, b) ");
+  expand("function-like: STR(a + b)", "STR(a + b) ");
+  expand("function-like: NEST(NEST(1))", "NEST(NEST(1)) ");
+  expand("function-like: NEST(NEST(1)), cold pool", "NEST(NEST(1)) ", true);
+}
@@ -0,0 +1,66 @@
+#include<messer/core.hpp>
+#include<bench/micro/micro.hpp>
+
+namespace{
+
+std::string read_file(const std::filesystem::path& path){
+  std::ifstream ifs{path};
+  return std::string(std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{});
+}
+
+std::string synthetic_source(){
+  std::string src;
+  for(int i = 0; i < 2000; ++i)
+    src += "#define MACRO_" + std::to_string(i) + "(a, b) ((a) << " + std::to_string(i % 31) + " | (b)) /* comment */\n"
+           "int value_" + std::to_string(i) + " = MACRO_" + std::to_string(i) + "(0x1f, 'c') + 1.5e3; // \\\n  continued\n"
+           "const char* s_" + std::to_string(i) + " = \"string\\tliteral\";\r\n";
+  return src;
+}
+
+std::filesystem::path real_input(int argc, char** argv){
+  if(argc > 1)
+    return argv[1];
+  const char* include_dirs[] = {
+    #include "include_dir.ipp"
+  };
+  for(auto&& x : include_dirs)
+    if(std::filesystem::exists(std::filesystem::path{x}/"bits/stl_algo.h"))
+      return std::filesystem::path{x}/"bits/stl_algo.h";
+  return "bench/corpus/x_macro.cpp";
+}
+
+void run(std::string_view name, const std::string& src){
+  using messer::annotation;
+  static constexpr messer::phase1_t phase1;
+  static constexpr messer::phase2_t phase2;
+  static constexpr messer::phase3_t phase3;
+  const double mb = src.size() / 1e6;
+  messer::micro::measure(std::string{name} + ": phase1", [&]{
+    std::size_t n = 0;
+    for(auto&& c : src | annotation{"<bench>"} | phase1)
+      n += c;
+    messer::micro::do_not_optimize(n);
+  }, mb, "MB");
+  messer::micro::measure(std::string{name} + ": phase1+phase2", [&]{
+    std::size_t n = 0;
+    for(auto&& c : src | annotation{"<bench>"} | phase1 | phase2)
+      n += c;
+    messer::micro::do_not_optimize(n);
+  }, mb, "MB");
+  std::size_t tokens = 0;
+  for(auto&& x : src | annotation{"<bench>"} | phase1 | phase2 | phase3)
+    tokens += x.type() != messer::token_type::empty;
+  messer::micro::measure(std::string{name} + ": phase3", [&]{
+    auto range = src | annotation{"<bench>"} | phase1 | phase2 | phase3;
+    std::list<messer::phase3_t::value_type> list(range.begin(), range.end());
+    messer::micro::do_not_optimize(list);
+  }, static_cast<double>(tokens), "tokens");
+}
+
+}
+
+int main(int argc, char** argv){
+  run("synthetic", synthetic_source());
+  const auto path = real_input(argc, argv);
+  run(path.filename().string(), read_file(path));
+}
@@ -0,0 +1,60 @@
+#ifndef MESSER_BENCH_MICRO_HPP_INCLUDED
+#define MESSER_BENCH_MICRO_HPP_INCLUDED
+
+#include<chrono>
+#include<cstddef>
+#include<iomanip>
+#include<iostream>
+#include<string_view>
+
+namespace messer::micro{
+
+// operator new calls so far, counted by bench/alloc_counter.cpp
+std::size_t allocation_count();
+
+template<typename T>
+inline void do_not_optimize(T&& t){
+  asm volatile("" : : "g"(&t) : "memory");
+}
+
+// Runs f repeatedly for at least min_time and reports time and allocations per iteration and,
+// when units_per_iteration is non-zero, the throughput in `unit`/s.
+template<typename F>
+inline void measure(std::string_view name, F&& f, double units_per_iteration = 0, std::string_view unit = "", std::chrono::duration<double> min_time = std::chrono::milliseconds{500}){
+  using clock = std::chrono::steady_clock;
+  std::size_t iterations = 0;
+  const auto allocations = allocation_count();
+  const auto start = clock::now();
+  auto elapsed = clock::duration{};
+  do{
+    f();
+    ++iterations;
+    elapsed = clock::now() - start;
+  }while(elapsed < min_time);
+  const auto allocated = allocation_count() - allocations;
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  const auto flags = std::cout.flags();
+  std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << seconds / iterations * 1e9 << " ns/iter"
+            << std::setw(12) << static_cast<double>(allocated) / iterations << " allocs/iter";
+  if(units_per_iteration > 0)
+    std::cout << std::setw(14) << std::setprecision(2) << units_per_iteration * iterations / seconds << ' ' << unit << "/s";
+  std::cout << '\n';
+  std::cout.flags(flags);
+}
+
+template<typename F>
+inline void measure_once(std::string_view name, F&& f){
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  f();
+  const auto ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+  const auto flags = std::cout.flags();
+  std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << ns << " ns/iter\n";
+  std::cout.flags(flags);
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include<messer/core.hpp>
+#include<bench/micro/micro.hpp>
+
+namespace{
+
+using token_t = messer::phase4_t::token_t;
+
+std::list<token_t> lex(const std::string& src, std::string_view filename){
+  auto ret = messer::lex(src, filename);
+  ret.pop_front(); //first eol
+  return ret;
+}
+
+}
+
+int main(){
+  messer::phase4_t state;
+  {
+    const char* include_dirs[] = {
+      #include "include_dir.ipp"
+    };
+    for(auto&& x : include_dirs)
+      state.system_include_dir.emplace_back(x);
+  }
+  {
+    const auto lhs = lex("identifier", "<bench>");
+    const auto rhs = lex("_suffix", "<bench>");
+    const auto hashhash = lex("##", "<bench>");
+    messer::micro::measure("cat_token: identifier ## identifier", [&]{
+      auto t = messer::phase4_t::eval_macro_t::cat_token(lhs.front(), rhs.front(), hashhash.cbegin());
+      messer::micro::do_not_optimize(t);
+    });
+  }
+  {
+    const auto tokens = lex("a + b * \"string \\\"literal\\\"\" - 'c' /* comment */ f(x, y)", "<bench>");
+    messer::micro::measure("stringizer: 17 tokens", [&]{
+      auto s = messer::stringizer(tokens.cbegin(), tokens.cend());
+      messer::micro::do_not_optimize(s);
+    }, static_cast<double>(tokens.size()), "tokens");
+  }
+  {
+    std::string src;
+    for(int i = 0; i < 100; ++i)
+      src += "\"lorem ipsum\\n\" \"dolor sit amet\" u8\"\\x41\" x ";
+    const auto tokens = lex(src, "<bench>");
+    messer::micro::measure("phase6: 100 runs of adjacent literals", [&]{
+      messer::phase6_t phase6;
+      std::size_t count = 0;
+      const auto sink = [&count](const token_t& t){count += t.get().size();};
+      for(auto&& x : tokens)
+        phase6(x, sink);
+      phase6.finish(sink);
+      messer::micro::do_not_optimize(count);
+    }, static_cast<double>(tokens.size()), "tokens");
+  }
+  {
+    const auto tokens = lex("(1 + 2 * 3 - (4 << 2)) % 7 == 2 && !(0x10 | 3) || 100 / 3 > 30 ? 1 : 0", "<bench>");
+    messer::micro::measure("evaluate_condition", [&]{
+      auto ret = state.evaluate_condition(tokens, std::filesystem::current_path());
+      messer::micro::do_not_optimize(ret);
+    }, static_cast<double>(tokens.size()), "tokens");
+  }
+  for(auto&& header : {"<vector>", "<boost/preprocessor.hpp>", "\"nonexistent.h\""}){
+    const auto tokens = lex(header, "<bench>");
+    const auto current_path = std::filesystem::current_path();
+    messer::micro::measure_once(std::string{"find_include_path (cold): "} + header, [&]{
+      auto ret = state.find_include_path(tokens, current_path);
+      messer::micro::do_not_optimize(ret);
+    });
+    messer::micro::measure(std::string{"find_include_path (warm): "} + header, [&]{
+      auto ret = state.find_include_path(tokens, current_path);
+      messer::micro::do_not_optimize(ret);
+    });
+  }
+}
@@ -0,0 +1,2856 @@
+#ifndef MESSER_CORE_HPP_INCLUDED
+#define MESSER_CORE_HPP_INCLUDED
+
+#include<type_traits>
+#include<utility>
+#include<iterator>
+#include<string>
+#include<string_view>
+#include<optional>
+#include<variant>
+#include<filesystem>
+#include<fstream>
+#include<veiler/hastur.hpp>
+#include<veiler/lampads.hpp>
+#include<veiler/pegasus.hpp>
+#include<messer/token_type.hpp>
+
+namespace messer{
+
+template<typename Iterator>
+class output_range{
+  Iterator be, en;
+ public:
+  output_range() = default;
+  output_range(const output_range&)noexcept = default;
+  output_range(output_range&&)noexcept = default;
+  output_range& operator=(const output_range&)noexcept = default;
+  output_range& operator=(output_range&&)noexcept = default;
+  template<typename I, typename J>
+  output_range(I&& b, J&& e):be(std::forward<I>(b)), en(std::forward<J>(e)){}
+  const Iterator& begin()const{return be;}
+  const Iterator& end  ()const{return en;}
+  friend std::ostream& operator<<(std::ostream& os, const output_range& r){
+    for(auto&& x : r)
+      os << x;
+    return os;
+  }
+};
+
+namespace detail{
+
+using has_get_raw = VEILER_HASTUR_TAG_CREATE(get_raw);
+
+template<typename T>class pointer_iterator;
+template<typename T>class pointer_iterator<T*>{
+  T* ptr;
+  using self = pointer_iterator<T*>;
+ public:
+  pointer_iterator() = default;
+  pointer_iterator(T* ptr):ptr(ptr){}
+  pointer_iterator(const pointer_iterator&) = default;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+  using iterator_category = std::random_access_iterator_tag;
+  value_type operator*()const{return *ptr;}
+  self& operator++(){++ptr;return *this;}
+  self operator++(int){self t = *this; ++(*this); return t;}
+  self& operator+=(std::size_t n){ptr += n;return *this;}
+  self& operator--(){--ptr;return *this;}
+  self operator--(int){self t = *this;--(*this);return t;}
+  self operator-=(std::size_t n){ptr -= n;return *this;}
+  friend self operator+ (const self& lhs, std::size_t n){self t = lhs; t += n; return t;}
+  friend self operator- (const self& lhs, std::size_t n){self t = lhs; t -= n; return t;}
+  friend std::ptrdiff_t operator- (const self& lhs, const self& rhs){return lhs.ptr-rhs.ptr;}
+  friend bool operator==(const self& lhs, const self& rhs)noexcept{return lhs.ptr == rhs.ptr;}
+  friend bool operator!=(const self& lhs, const self& rhs)noexcept{return !(lhs == rhs);}
+};
+
+template<typename T>
+using to_inheritable_iterator = std::conditional_t<std::is_pointer<T>::value, pointer_iterator<T>, T>;
+
+}//namespace detail
+
+template<typename FilterIterator, std::enable_if_t<veiler::hastur<detail::has_get_raw>::func<FilterIterator>{}>* = nullptr>
+inline auto&& get_raw(FilterIterator&& it){
+  return std::forward<FilterIterator>(it).get_raw();
+}
+
+template<typename Iterator, std::enable_if_t<!veiler::hastur<detail::has_get_raw>::func<Iterator>{}>* = nullptr>
+inline auto&& get_raw(Iterator&& it){
+  return std::forward<Iterator>(it);
+}
+
+struct annotation_type{
+  std::string_view filename;
+  std::size_t line;
+  std::size_t column;
+};
+
+template<typename T>
+class annotation_range{
+  class annotation_iterator:public detail::to_inheritable_iterator<decltype(std::begin(std::declval<T>()))>{
+    using self = annotation_iterator;
+    using parent = detail::to_inheritable_iterator<decltype(std::begin(std::declval<T>()))>;
+    annotation_type data;
+   public:
+    annotation_iterator() = default;
+    annotation_iterator(const parent& it, std::string_view fn, std::size_t l = 1, std::size_t c = 1):parent{it}, data{fn, l, c}{}
+    annotation_iterator(const parent& it, const annotation_type& an):parent{it}, data{an}{}
+    annotation_iterator(const self&) = default;
+    std::string_view get_filename()const{return data.filename;}
+    std::size_t get_line()const{return data.line;}
+    std::size_t get_column()const{return data.column;}
+    self& operator++(){
+      if(**this == '\n'){
+        ++data.line;
+        data.column = 1;
+      }
+      else
+        ++data.column;
+      ++*static_cast<parent*>(this);
+      return *this;
+    }
+    self operator++(int){self t = *this; ++(*this); return t;}
+    const annotation_type& get_annotate()const{return data;}
+    const parent& get_inner()const{return *this;}
+  };
+  annotation_type annot_data;
+  T&& t;
+ public:
+  using iterator = annotation_iterator;
+  using const_iterator = iterator;
+  using value_type = decltype(*std::declval<decltype(std::begin(std::declval<T>()))>());
+  annotation_range(annotation_type anno, T&& data):annot_data(std::move(anno)), t(std::forward<T>(data)){}
+  annotation_iterator begin()const{return annotation_iterator{t.begin(), annot_data};}
+  annotation_iterator end()const{return annotation_iterator{t.end(), annot_data};}
+};
+
+class annotation{
+  annotation_type data;
+ public:
+  annotation(const std::string_view& filename, std::size_t l = 1, std::size_t c = 1):data{filename, l, c}{}
+  annotation(const annotation_type& anno):data{anno}{}
+  template<typename T>
+  friend constexpr auto operator|(T&& t, annotation&& a)noexcept{
+    return annotation_range<T>{std::move(a.data), std::forward<T>(t)};
+  }
+};
+
+template<typename T>
+class filter_iterator : T{
+  using self = filter_iterator<T>;
+  std::optional<typename T::value_type> t;
+ public:
+  using typename T::value_type;
+  template<typename... Args>
+  explicit filter_iterator(Args&&... args):T{std::forward<Args>(args)...}{}
+  filter_iterator(const filter_iterator& other):T{other}{}
+  filter_iterator& operator=(const filter_iterator& other){static_cast<T&>(*this) = other; return *this;}
+  value_type& operator*(){t = this->dereference();return *t;}
+  value_type operator*()const{return this->dereference();}
+  value_type* operator->(){return &**this;}
+  self& operator++(){this->next();return *this;}
+  self operator++(int){self t = *this; ++(*this); return t;}
+  self& operator+=(std::size_t n){while(n-->0)++(*this);return *this;}
+  auto&& get_raw(){return this->get_raw_iterator();}
+  auto&& get_raw()const{return this->get_raw_iterator();}
+  friend self operator+(const self& lhs, std::size_t n){self t = lhs; t += n; return t;}
+  friend bool operator==(const self& lhs, const self& rhs)noexcept{return lhs.is_equal(rhs);}
+  friend bool operator!=(const self& lhs, const self& rhs)noexcept{return !(lhs == rhs);}
+};
+
+}
+
+namespace std{
+
+template<typename T>struct iterator_traits<messer::filter_iterator<T>>{
+  using value_type = typename messer::filter_iterator<T>::value_type;
+  using iterator = messer::filter_iterator<T>;
+  using iterator_category = forward_iterator_tag;
+  using reference = value_type&;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+};
+
+}
+
+namespace veiler{
+
+template<typename T>
+struct hash<messer::filter_iterator<T>> : hash<typename messer::filter_iterator<T>::value_type>{
+  constexpr hash() = default;
+  constexpr hash(const hash&) = default;
+  constexpr hash(hash&&) = default;
+  ~hash() = default;
+  hash& operator=(const hash&) = default;
+  hash& operator=(hash&&) = default;
+  using result_type = std::size_t;
+  using argument_type = messer::filter_iterator<T>;
+  std::size_t operator()(const argument_type& key)const noexcept{
+    return veiler::hash<typename messer::filter_iterator<T>::value_type>::operator()(*key);
+  }
+};
+
+}
+
+namespace messer{
+
+template<typename T, template<typename>class IteratorImpl>
+class filter_range{
+  T t;
+ public:
+  using iterator = filter_iterator<IteratorImpl<std::decay_t<T>>>;
+  using const_iterator = iterator;
+  using value_type = typename iterator::value_type;
+  filter_range(T&& t):t{std::forward<T>(t)}{}
+  iterator begin()const{using std::begin;using std::end;return iterator{begin(t), end(t)};}
+  iterator end  ()const{                 using std::end;return iterator{end  (t), end(t)};}
+  friend std::ostream& operator<<(std::ostream& os, const filter_range<T, IteratorImpl>& rhs){
+    for(auto&& x : rhs)
+      os << x;
+    return os;
+  }
+};
+
+class phase1_t{
+  template<typename T>
+  struct crlf_to_lf_iterator_impl{
+    using iterator = typename T::const_iterator;
+   private:
+    iterator b;
+    iterator e;
+    bool is_target()const noexcept{
+      if(*b != '\r')
+        return false;
+      const auto next = std::next(b);
+      return next != e && *next == '\n';
+    }
+   public:
+    using value_type = std::enable_if_t<std::is_convertible<typename T::value_type, char>::value, char>;
+    crlf_to_lf_iterator_impl() = default;
+    crlf_to_lf_iterator_impl(const iterator& b, const iterator& e):b{b}, e{e}{}
+    crlf_to_lf_iterator_impl(const crlf_to_lf_iterator_impl&) = default;
+    crlf_to_lf_iterator_impl& operator=(const crlf_to_lf_iterator_impl& other){b = other.b; e = other.e;return *this;}
+    value_type dereference()const{
+      return *b;
+    }
+    
+    void next(){
+      ++b;
+      if(is_target())
+        ++b;
+    }
+    bool is_equal(const crlf_to_lf_iterator_impl& other)const noexcept{return b == other.b;}
+          auto& get_raw_iterator()     {return get_raw(b);}
+    const auto& get_raw_iterator()const{return get_raw(b);}
+  };
+  template<typename T>
+  class trigraph_iterator_impl{
+    static char trigraph_convert(char c){
+      switch(c){
+        case '=' : return '#';
+        case '(' : return '[';
+        case '/' : return '\\';
+        case ')' : return ']';
+        case '\'': return '^';
+        case '<' : return '{';
+        case '!' : return '|';
+        case '>' : return '}';
+        case '-' : return '~';
+      }
+      return -1;
+    }
+   public:
+    using iterator = typename T::const_iterator;
+   private:
+    iterator b;
+    iterator e;
+    bool is_trigraph()const noexcept{
+      if(*b != '?')
+        return false;
+      auto next = std::next(b);
+      if(next == e || *next != '?')
+        return false;
+      next = std::next(next);
+      return next != e && trigraph_convert(*next) != -1;
+    }
+   public:
+    using value_type = std::enable_if_t<std::is_convertible<typename T::value_type, char>::value, char>;
+    trigraph_iterator_impl() = default;
+    trigraph_iterator_impl(const iterator& b, const iterator& e):b{b}, e{e}{}
+    trigraph_iterator_impl(const trigraph_iterator_impl&) = default;
+    trigraph_iterator_impl& operator=(const trigraph_iterator_impl& other){b = other.b;return *this;}
+    value_type dereference()const{
+      if(is_trigraph())
+        return trigraph_convert(*std::next(b,2));
+      return *b;
+    }
+    void next(){
+      if(is_trigraph())
+        std::advance(b, 3);
+      else
+        ++b;
+    }
+    bool is_equal(const trigraph_iterator_impl& other)const noexcept{return b == other.b;}
+          auto& get_raw_iterator()     {return get_raw(b);}
+    const auto& get_raw_iterator()const{return get_raw(b);}
+  };
+  template<typename T>
+  using trigraph = filter_range<T, trigraph_iterator_impl>;
+  template<typename T>
+  using crlf_to_lf = filter_range<T, crlf_to_lf_iterator_impl>;
+ public:
+  template<typename T>
+  friend constexpr auto operator|(T&& t, const phase1_t&)noexcept{
+    return /*trigraph<*/crlf_to_lf<T>/*>*/{{std::forward<T>(t)}};
+  }
+};
+
+class phase2_t{
+  template<typename T>
+  struct backslash_eol_iterator_impl{
+    using iterator = typename T::const_iterator;
+   private:
+    iterator b;
+    iterator e;
+    bool is_target()const noexcept{
+      if(*b != '\\')
+        return false;
+      const auto next = std::next(b);
+      return next != e && *next == '\n';
+    }
+    void skip(){
+      while(is_target())
+        std::advance(b, 2);
+    }
+   public:
+    using value_type = std::enable_if_t<std::is_convertible<typename T::value_type, char>::value, char>;
+    backslash_eol_iterator_impl() = default;
+    backslash_eol_iterator_impl(const iterator& b, const iterator& e):b{b}, e{e}{skip();}
+    backslash_eol_iterator_impl(const backslash_eol_iterator_impl&) = default;
+    backslash_eol_iterator_impl& operator=(const backslash_eol_iterator_impl& other){b = other.b;return *this;}
+    value_type dereference()const{
+      return *b;
+    }
+    void next(){
+      ++b;
+      skip();
+    }
+    bool is_equal(const backslash_eol_iterator_impl& other)const noexcept{return b == other.b;}
+          auto& get_raw_iterator()     {return get_raw(b);}
+    const auto& get_raw_iterator()const{return get_raw(b);}
+  };
+  template<typename T>
+  using backslash_eol = filter_range<T, backslash_eol_iterator_impl>;
+ public:
+  template<typename T>
+  friend constexpr auto operator|(T&& t, const phase2_t&)noexcept{
+    return backslash_eol<T>{std::forward<T>(t)};
+  }
+};
+
+template<typename StrT>
+class token{
+  StrT str;
+  token_type tt;
+ public:
+  template<typename T>
+  token(T&& str, token_type tok):str{std::forward<T>(str)}, tt{tok}{}
+  token_type type()const{return tt;}
+  token_type& type(){return tt;}
+  const StrT& get()const{return str;}
+  friend std::ostream& operator<<(std::ostream& os, const token& tkn){return os << tkn.str;}
+};
+
+#define RULE VEILER_PEGASUS_RULE
+#define AUTO_RULE VEILER_PEGASUS_AUTO_RULE
+#define INLINE_RULE VEILER_PEGASUS_INLINE_RULE
+
+class phase3_t{
+  struct lexer : veiler::pegasus::parsers<lexer>{
+    static auto entrypoint(){
+      return instance().preprocessing_token;
+    }
+    static auto inner_include(){
+      return instance().rule_inner_include;
+    }
+   private:
+    static constexpr auto location = veiler::pegasus::semantic_actions::location;
+    static constexpr auto omit = veiler::pegasus::semantic_actions::omit;
+    static constexpr auto read = veiler::pegasus::read;
+    static constexpr auto value = veiler::pegasus::semantic_actions::value;
+    template<typename T>
+    static constexpr auto lit(T&& t){return veiler::pegasus::lit(std::forward<T>(t));}
+    template<typename T, typename U>
+    static constexpr auto range(T&& t, U&& u){return veiler::pegasus::range(std::forward<T>(t), std::forward<U>(u));}
+    static constexpr auto set_token(token_type t){
+      return [t](auto&& loc, [[maybe_unused]] auto&&... unused){return std::make_pair(loc, t);};
+    }
+    AUTO_RULE(rule_inner_include, veiler::pegasus::transient(
+           rules.header_name
+        |  rules.preprocessing_token
+        ))
+    AUTO_RULE(header_name, veiler::pegasus::transient(
+        (  lit('<') >> +rules.h_char >> lit('>')
+        |  lit('"') >> +rules.q_char >> lit('"')
+        )[location][set_token(token_type::header_name)]
+        ))
+    AUTO_RULE(h_char, veiler::pegasus::transient(
+           omit[read - lit('\n') - lit('>')]
+        ))
+    AUTO_RULE(q_char, veiler::pegasus::transient(
+           omit[read - lit('\n') - lit('"')]
+        ))
+    AUTO_RULE(preprocessing_token, veiler::pegasus::transient(
+           rules.white_spaces[location][set_token(token_type::white_space)]
+        |  lit('\n')[location][set_token(token_type::eol)]
+        |  rules.pp_number[location][set_token(token_type::pp_number)]
+        |  rules.punctuators
+        |  rules.character_literal[location][set_token(token_type::character_literal)]
+        |  rules.string_literal
+        |  rules.directive
+        |  (lit("true") >> !rules.identifier)[location][set_token(token_type::identifier_true)]
+        |  (lit("false") >> !rules.identifier)[location][set_token(token_type::identifier_false)]
+        |  (lit("defined") >> !rules.identifier)[location][set_token(token_type::identifier_defined)]
+        |  (lit("__TIME__") >> !rules.identifier)[location][set_token(token_type::identifier_time_)]
+        |  (lit("__DATE__") >> !rules.identifier)[location][set_token(token_type::identifier_date_)]
+        |  (lit("__FILE__") >> !rules.identifier)[location][set_token(token_type::identifier_file_)]
+        |  (lit("__LINE__") >> !rules.identifier)[location][set_token(token_type::identifier_line_)]
+        |  (lit("_Pragma") >> !rules.identifier)[location][set_token(token_type::identifier_pragma_op)]
+        |  (lit("__has_include") >> !rules.identifier)[location][set_token(token_type::identifier_has_include)]
+        |  rules.identifier[location][set_token(token_type::identifier)]
+        |  read[location][set_token(token_type::unclassified_character)]
+        ))
+    AUTO_RULE(punctuators, veiler::pegasus::transient(
+           lit("%:%:"  )[location][set_token(token_type::punctuator_hashhash)]
+        |  lit("..."   )[location][set_token(token_type::punctuator_ellipsis)]
+        |  lit("<<="   )[location][set_token(token_type::punctuator)]
+        |  lit(">>="   )[location][set_token(token_type::punctuator)]
+        |  lit("->*"   )[location][set_token(token_type::punctuator)]//C++
+        |  lit(".*"    )[location][set_token(token_type::punctuator)]//C++
+        |  lit("%:"    )[location][set_token(token_type::punctuator_hash)]
+        |  lit("<:"    )[location][set_token(token_type::punctuator)]
+        |  lit(":>"    )[location][set_token(token_type::punctuator)]
+        |  lit("<%"    )[location][set_token(token_type::punctuator)]
+        |  lit("%>"    )[location][set_token(token_type::punctuator)]
+        |  lit("##"    )[location][set_token(token_type::punctuator_hashhash)]
+        |  lit("<<"    )[location][set_token(token_type::punctuator_left_shift)]
+        |  lit(">>"    )[location][set_token(token_type::punctuator_right_shift)]
+        |  lit("->"    )[location][set_token(token_type::punctuator)]
+        |  lit("++"    )[location][set_token(token_type::punctuator)]
+        |  lit("--"    )[location][set_token(token_type::punctuator)]
+        |  lit("<="    )[location][set_token(token_type::punctuator_less_equal)]
+        |  lit(">="    )[location][set_token(token_type::punctuator_greater_equal)]
+        |  lit("=="    )[location][set_token(token_type::punctuator_equalequal)]
+        |  lit("!="    )[location][set_token(token_type::punctuator_not_equal)]
+        |  lit("&&"    )[location][set_token(token_type::punctuator_logical_and)]
+        |  lit("||"    )[location][set_token(token_type::punctuator_logical_or)]
+        |  lit("*="    )[location][set_token(token_type::punctuator)]
+        |  lit("/="    )[location][set_token(token_type::punctuator)]
+        |  lit("%="    )[location][set_token(token_type::punctuator)]
+        |  lit("+="    )[location][set_token(token_type::punctuator)]
+        |  lit("-="    )[location][set_token(token_type::punctuator)]
+        |  lit("&="    )[location][set_token(token_type::punctuator)]
+        |  lit("^="    )[location][set_token(token_type::punctuator)]
+        |  lit("|="    )[location][set_token(token_type::punctuator)]
+        |  lit("::"    )[location][set_token(token_type::punctuator)]//C++
+        |  lit('#'     )[location][set_token(token_type::punctuator_hash)]
+        |  lit('['     )[location][set_token(token_type::punctuator)]
+        |  lit(']'     )[location][set_token(token_type::punctuator)]
+        |  lit('('     )[location][set_token(token_type::punctuator_left_parenthesis)]
+        |  lit(')'     )[location][set_token(token_type::punctuator_right_parenthesis)]
+        |  lit('{'     )[location][set_token(token_type::punctuator)]
+        |  lit('}'     )[location][set_token(token_type::punctuator)]
+        |  lit('.'     )[location][set_token(token_type::punctuator)]
+        |  lit('&'     )[location][set_token(token_type::punctuator_ampersand)]
+        |  lit('*'     )[location][set_token(token_type::punctuator_asterisk)]
+        |  lit('+'     )[location][set_token(token_type::punctuator_plus)]
+        |  lit('-'     )[location][set_token(token_type::punctuator_minus)]
+        |  lit('~'     )[location][set_token(token_type::punctuator_bitwise_not)]
+        |  lit('!'     )[location][set_token(token_type::punctuator_logical_not)]
+        |  lit('/'     )[location][set_token(token_type::punctuator_division)]
+        |  lit('%'     )[location][set_token(token_type::punctuator_modulo)]
+        |  lit('<'     )[location][set_token(token_type::punctuator_less)]
+        |  lit('>'     )[location][set_token(token_type::punctuator_greater)]
+        |  lit('^'     )[location][set_token(token_type::punctuator_bitwise_xor)]
+        |  lit('|'     )[location][set_token(token_type::punctuator_bitwise_or)]
+        |  lit('?'     )[location][set_token(token_type::punctuator_question)]
+        |  lit(':'     )[location][set_token(token_type::punctuator_colon)]
+        |  lit(';'     )[location][set_token(token_type::punctuator)]
+        |  lit('='     )[location][set_token(token_type::punctuator)]
+        |  lit(','     )[location][set_token(token_type::punctuator_comma)]
+        |  lit("bitand")[location][set_token(token_type::punctuator_ampersand)] >> omit[!rules.identifier]
+        |  lit("and_eq")[location][set_token(token_type::punctuator)] >> omit[!rules.identifier]
+        |  lit("xor_eq")[location][set_token(token_type::punctuator)] >> omit[!rules.identifier]
+        |  lit("not_eq")[location][set_token(token_type::punctuator_not_equal)] >> omit[!rules.identifier]
+        |  lit("bitor" )[location][set_token(token_type::punctuator_bitwise_or)] >> omit[!rules.identifier]
+        |  lit("compl" )[location][set_token(token_type::punctuator_bitwise_not)] >> omit[!rules.identifier]
+        |  lit("or_eq" )[location][set_token(token_type::punctuator)] >> omit[!rules.identifier]
+        |  lit("and"   )[location][set_token(token_type::punctuator_logical_and)] >> omit[!rules.identifier]
+        |  lit("xor"   )[location][set_token(token_type::punctuator_bitwise_xor)] >> omit[!rules.identifier]
+        |  lit("not"   )[location][set_token(token_type::punctuator_logical_not)] >> omit[!rules.identifier]
+        |  lit("or"    )[location][set_token(token_type::punctuator_logical_or)] >> omit[!rules.identifier]
+        ))
+    AUTO_RULE(pp_number, veiler::pegasus::transient(
+           (  rules.digit
+           |  lit('.') >> rules.digit
+           )
+        >> *( -lit('\'') >>  rules.digit
+            | lit('e') >> rules.sign
+            | lit('E') >> rules.sign
+            | lit('p') >> rules.sign
+            | lit('P') >> rules.sign
+            | lit('.')
+            | -lit('\'') >> rules.ident_nondigit
+            )
+        ))
+    AUTO_RULE(character_literal, veiler::pegasus::transient(
+           -( lit("u8")
+            | rules.encoding_prefix
+            )
+        >> lit('\'')
+        >> +rules.c_char
+        >> lit('\'')
+        >> -rules.identifier//UDL
+        ))
+    AUTO_RULE(encoding_prefix, veiler::pegasus::transient(
+          lit('u')
+        | lit('U')
+        | lit('L')
+        ))
+    AUTO_RULE(c_char, veiler::pegasus::transient(
+           ( read - lit('\'') - lit('\\') - lit('\n') )
+        |  rules.escape_sequence
+        ))
+    AUTO_RULE(escape_sequence, veiler::pegasus::transient(
+           lit('\\')
+        >> (  lit('\'')
+           |  lit('"')
+           |  lit('?')
+           |  lit('\\')
+           |  lit('a')
+           |  lit('b')
+           |  lit('f')
+           |  lit('n')
+           |  lit('r')
+           |  lit('t')
+           |  lit('v')
+           |  rules.octo >> rules.octo >> rules.octo
+           |  rules.octo >> rules.octo
+           |  rules.octo
+           |  lit('x') >> +rules.hex
+           )
+        ))
+    AUTO_RULE(string_literal, veiler::pegasus::transient(
+         ( -( lit("u8")
+            | rules.encoding_prefix
+            )
+        >> lit('"')
+        >> *rules.s_char
+        >> lit('"')
+        >> -rules.identifier
+         )[location][set_token(token_type::string_literal)]
+         |
+         ( -( lit("u8")
+            | rules.encoding_prefix
+            )
+        >> lit("R\"")
+        >> veiler::pegasus::filter([&rules](auto&& v, auto&& end, auto&&... args){
+            const auto raw_string_literal_parser =
+             (*rules.d_char)[location][([](auto&& loc, auto&&, auto&& delim, [[maybe_unused]] auto&&... unused){delim.assign(loc.begin(), loc.end());return veiler::pegasus::unit{};})]
+          >> lit('(')
+          >> *(veiler::pegasus::read
+              - ( lit(')')
+               >> veiler::pegasus::loop(
+                   veiler::pegasus::eps[([](auto&&, auto&&, auto&& delim, [[maybe_unused]] auto&&... unused){return delim.size();})], 
+                   rules.d_char[value])[veiler::pegasus::semantic_actions::change_container<std::string>]
+                     [([](auto&& v, auto&& loc, auto&& delim, [[maybe_unused]] auto&&... unused)
+                       ->veiler::expected<veiler::pegasus::unit, veiler::pegasus::parse_error<decltype(loc.begin())>>{
+                         if(v != delim)return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"raw string literal: unmatch delimiter"});
+                         else return veiler::pegasus::unit{};
+                     })]
+               >> lit('"')
+                ))
+          >> lit(')')
+          >> veiler::pegasus::loop(
+                   veiler::pegasus::eps[([](auto&&, auto&&, auto&& delim, [[maybe_unused]] auto&&... unused){return delim.size();})], 
+                   rules.d_char)
+          >> &lit('"');
+            auto it = messer::get_raw(v);
+            auto ret = raw_string_literal_parser[omit](it, messer::get_raw(end), args...);
+            messer::get_raw(v) = it;
+            ++v;
+            return ret.valid();
+             })
+        >> -rules.identifier//UDL
+         )[location][set_token(token_type::string_literal)]
+        ))
+    AUTO_RULE(s_char, veiler::pegasus::transient(
+           ( read - lit('"') - lit('\\') - lit('\n') )
+        |  rules.escape_sequence
+        ))
+    AUTO_RULE(d_char, veiler::pegasus::transient(
+          read
+        - lit(' ')
+        - lit('(')
+        - lit(')')
+        - lit('\\')
+        - lit('\t')
+        - lit('\v')
+        - lit('\f')
+        - lit('\n')
+        ))
+    AUTO_RULE(directive, veiler::pegasus::transient(
+        (  lit("include") >> &( rules.white_spaces
+                              | lit('<')
+                              | lit('"')
+                              )
+        )[location][set_token(token_type::identifier_include)]
+        |
+        (  lit("define")  >> &  rules.white_spaces
+        )[location][set_token(token_type::identifier_define)]
+        |
+        (  lit("undef")   >> &  rules.white_spaces
+        )[location][set_token(token_type::identifier_undef)]
+        |
+        (  lit("line")    >> &  rules.white_spaces
+        )[location][set_token(token_type::identifier_line)]
+        |
+        (  lit("error")   >> &( rules.white_spaces
+                              | lit('\n')
+                              )
+        )[location][set_token(token_type::identifier_error)]
+        |
+        (  lit("pragma")  >> &( rules.white_spaces
+                              | lit('\n')
+                              )
+        )[location][set_token(token_type::identifier_pragma)]
+        |
+        (  lit("if")      >> &( rules.white_spaces
+                              | lit('(')
+                              )
+        )[location][set_token(token_type::identifier_if)]
+        |
+        (  lit("ifdef")   >> &  rules.white_spaces
+        )[location][set_token(token_type::identifier_ifdef)]
+        |
+        (  lit("ifndef")  >> &  rules.white_spaces
+        )[location][set_token(token_type::identifier_ifndef)]
+        |
+        (  lit("elif")    >> &( rules.white_spaces
+                              | lit('(')
+                              )
+        )[location][set_token(token_type::identifier_elif)]
+        |
+        (  lit("else")    >> &( rules.white_spaces
+                              | lit('\n')
+                              )
+        )[location][set_token(token_type::identifier_else)]
+        |
+        (  lit("endif")   >> &( rules.white_spaces
+                              | lit('\n')
+                              )
+        )[location][set_token(token_type::identifier_endif)]
+        ))
+    AUTO_RULE(identifier, veiler::pegasus::transient(
+        (
+           rules.ident_nondigit
+        >> *( rules.ident_nondigit
+            | rules.digit
+            )
+        )
+        ))
+    AUTO_RULE(white_spaces, veiler::pegasus::transient(
+           +( lit(' ')
+            | lit('\t')
+            | lit("/*") >> *( read - lit("*/") ) >> lit("*/")
+            | lit("//") >> *( read - lit('\n') )
+            | lit('\v')
+            | lit('\f')
+            )
+        ))
+    RULE(ident_nondigit, char, veiler::pegasus::transient(
+           rules.nondigit
+        ))
+    RULE(nondigit, char, veiler::pegasus::transient(
+           range('A', 'Z')[value]
+        |  range('a', 'z')[value]
+        |  lit('_')[value]
+        ))
+    RULE(digit, char, veiler::pegasus::transient(
+           range('0', '9')[value]
+        ))
+    RULE(hex, char, veiler::pegasus::transient(
+           rules.digit
+        |  range('A', 'F')[value]
+        |  range('a', 'f')[value]
+        ))
+    RULE(octo, char, veiler::pegasus::transient(
+           range('0', '7')[value]
+        ))
+    RULE(sign, char, veiler::pegasus::transient(
+           lit('+')[value]
+        |  lit('-')[value]
+        ))
+  };
+ public:
+  class value_type : public token<std::string>{
+    using parent = token<std::string>;
+    annotation_type data;
+   public:
+    value_type(parent&& tk, const annotation_type& anno):parent{std::move(tk)}, data{anno}{}
+    std::string_view filename()const{return data.filename;}
+    std::size_t line()const{return data.line;}
+    std::size_t column()const{return data.column;}
+    const annotation_type& annotation()const{return data;}
+    annotation_type& annotation(){return data;}
+    value_type& filename(std::string_view sv){data.filename = std::move(sv); return *this;}
+    value_type& line(std::size_t ln){data.line = ln; return *this;}
+    friend std::ostream& operator<<(std::ostream& os, const value_type& v){return os << *static_cast<const parent*>(&v);}
+  };
+ private:
+  template<typename T>
+  class lexer_iterator_impl{
+    using impl = typename T::iterator;
+    impl it;
+    impl end;
+    enum class status{
+      first,
+      pp_directive,
+      include,
+      none
+    }st = status::first;
+    token_type tkt = token_type::eol;
+    impl beg;
+    bool result;
+   public:
+    using value_type = phase3_t::value_type;
+    using iterator = filter_iterator<lexer_iterator_impl<T>>;
+    lexer_iterator_impl(const impl& b, const impl& e):it(b), end(e), beg(b), result(b != e){}
+    lexer_iterator_impl(const lexer_iterator_impl&) = default;
+    lexer_iterator_impl& operator=(const lexer_iterator_impl&) = default;
+    value_type dereference()const{
+      if(!result)
+        throw std::runtime_error("can't dereference it");
+      const auto& i = get_raw(beg);
+      const auto anno = annotation_type{i.get_filename(), i.get_line(), i.get_column()};
+      if(tkt != token_type::string_literal || *beg == '"')
+        return value_type{token<std::string>{std::string{beg, it}, tkt}, anno};
+      auto itt = beg;
+      while(std::next(itt) != end && *std::next(itt) != '"')
+        ++itt;
+      if(*itt != 'R')
+        return value_type{token<std::string>{std::string{beg, it}, tkt}, anno};
+      ++itt;
+      auto edit = itt;
+      auto edit_raw = messer::get_raw(edit);
+      std::string delimiter;
+      for(auto itr = std::next(edit_raw); *itr != '('; ++itr)
+        delimiter.push_back(*itr);
+      std::advance(edit_raw, delimiter.size());
+      while(true){
+        while(*edit_raw++ != ')');
+        auto itr = edit_raw;
+        for(auto&& x : delimiter){
+          if(*itr++ != x)
+            break;
+        }
+        if(*itr == '"'){
+          messer::get_raw(edit) = itr;
+          break;
+        }
+      }
+      return value_type{token<std::string>{std::string{beg, itt} + std::string{messer::get_raw(itt).get_inner(), messer::get_raw(edit).get_inner()} + std::string{edit, it} , tkt}, anno};
+    }
+    void next(){
+      if(!result)
+        return;
+      beg = it;
+      auto ret = (st == status::include ? 
+        lexer::inner_include()(it, end, std::string{}):
+        lexer::entrypoint   ()(it, end, std::string{}));
+      result = ret && it != beg;
+      if(!result)
+        return;
+      tkt = ret--->second;
+      if(st == status::first && tkt == token_type::punctuator_hash)
+        st = status::pp_directive;
+      else if(st == status::pp_directive && tkt == token_type::identifier_include)
+        st = status::include;
+      else if(tkt == token_type::eol)
+        st = status::first;
+      else if(tkt != token_type::white_space)
+        st = status::none;
+    }
+    bool is_equal(const lexer_iterator_impl& other)const noexcept{return result == other.result && it == other.it;}
+          auto& get_raw_iterator()     {return it;}
+    const auto& get_raw_iterator()const{return it;}
+  };
+  template<typename T>
+  using lexer_range = filter_range<T, lexer_iterator_impl>;
+ public:
+  template<typename T>
+  friend constexpr auto operator|(T&& t, const phase3_t&)noexcept{
+    return lexer_range<T>{std::forward<T>(t)};
+  }
+};
+
+}
+
+namespace veiler{
+
+template<>
+struct hash<messer::phase3_t::value_type> : hash<std::underlying_type_t<messer::token_type>>, hash<std::string>, hash<std::string_view>,  hash<std::size_t>{
+  constexpr hash() = default;
+  constexpr hash(const hash&) = default;
+  constexpr hash(hash&&) = default;
+  ~hash() = default;
+  hash& operator=(const hash&) = default;
+  hash& operator=(hash&&) = default;
+  using result_type = std::size_t;
+  using argument_type = messer::phase3_t::value_type;
+  std::size_t operator()(const argument_type& key)const noexcept{
+    return detail::fool::hash_combine(hash<std::underlying_type_t<messer::token_type>>::operator()(static_cast<std::underlying_type_t<messer::token_type>>(key.type())), hash<std::string>::operator()(key.get()), hash<std::string_view>::operator()(key.filename()), hash<std::size_t>::operator()(key.line()), hash<std::size_t>::operator()(key.column()));
+  }
+};
+
+}
+
+namespace veiler::pegasus{
+
+template<>
+struct member_accessor<std::string_view, messer::phase3_t::value_type>{
+  static const std::string& access(const messer::phase3_t::value_type& t){return t.get();}
+};
+template<>
+struct member_accessor<std::string, messer::phase3_t::value_type>{
+  static const std::string& access(const messer::phase3_t::value_type& t){return t.get();}
+};
+template<>
+struct member_accessor<const char*, messer::phase3_t::value_type>{
+  static const std::string& access(const messer::phase3_t::value_type& t){return t.get();}
+};
+template<>
+struct member_accessor<messer::token_type, messer::phase3_t::value_type>{
+  static messer::token_type access(const messer::phase3_t::value_type& t){return t.type();}
+};
+
+}
+
+#include<iostream>
+#include<vector>
+#include<list>
+namespace messer{
+
+std::list<phase3_t::value_type> lex(const std::string& source, std::string_view filename, std::size_t line = 1);
+std::list<phase3_t::value_type> lex_pasted(const std::string& source, const annotation_type& annotation);
+bool read_logical_line(std::istream& is, std::string& buffer);
+// keeps the lines of #include, conditional, #define and #undef directives and empties the others
+std::string minimize_directives(const std::string& source);
+
+template<typename T, typename U>
+inline bool tokens_equal(const T& t, const U& u){
+  if(t.size() != u.size())
+    return false;
+  for(auto t_it = t.begin(), u_it = u.begin(); t_it != t.end(); ++t_it, ++u_it)
+    if(t_it->get() != u_it->get())
+      return false;
+  return true;
+}
+
+template<typename T>
+inline std::vector<T> vector_product(std::vector<T> x, std::vector<T> y){
+  std::sort(x.begin(), x.end());
+  std::sort(y.begin(), y.end());
+  std::vector<T> product;
+  product.reserve(x.size() + y.size());
+  std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(product));
+  return product;
+}
+
+namespace detail{
+
+template<typename T>
+struct list_replace_1{
+  output_range<typename std::list<T>::const_iterator> r;
+  std::list<T> data;
+  output_range<typename std::list<T>::iterator> operator()(std::list<T>& l){
+    if(data.empty()){
+      const auto it = l.erase(r.begin(), r.end());
+      return output_range<typename std::list<T>::iterator>{it, it};
+    }
+    const auto inserted_begin = data.begin();
+    l.splice(r.begin(), std::move(data));
+    return output_range<typename std::list<T>::iterator>{inserted_begin, l.erase(r.begin(), r.end())};
+  }
+  friend output_range<typename std::list<T>::iterator> operator|(std::list<T>& l, list_replace_1&& rep){return std::move(rep)(l);}
+  list_replace_1(output_range<typename std::list<T>::const_iterator> r, std::list<T>&& data):r{std::move(r)}, data{std::move(data)}{}
+  list_replace_1(output_range<typename std::list<T>::iterator> r, std::list<T>&& data):r{r.begin(), r.end()}, data{std::move(data)}{}
+};
+
+template<typename T>
+struct list_replace_2{
+  output_range<typename std::list<T>::iterator> r;
+  T data;
+  output_range<typename std::list<T>::iterator> operator()(std::list<T>& l){
+    const auto inserted_begin = l.insert(r.begin(), std::move(data));
+    return {inserted_begin, l.erase(r.begin(), r.end())};
+  }
+  friend output_range<typename std::list<T>::iterator> operator|(std::list<T>& l, list_replace_2&& rep){return std::move(rep)(l);}
+};
+
+template<typename T, typename U>
+struct list_replace_3{
+  output_range<typename std::list<T>::iterator> r;
+  output_range<U> data;
+  output_range<typename std::list<T>::iterator> operator()(std::list<T>& l){
+    const auto inserted_begin = l.insert(r.begin(), data.begin(), data.end());
+    return {inserted_begin, l.erase(r.begin(), r.end())};
+  }
+  friend output_range<typename std::list<T>::iterator> operator|(std::list<T>& l, list_replace_3&& rep){return std::move(rep)(l);}
+};
+
+}
+
+template<typename T>
+inline detail::list_replace_1<typename std::iterator_traits<T>::value_type> replacer(const T& rb, const T& re, std::list<typename std::iterator_traits<T>::value_type> l){return detail::list_replace_1<typename std::iterator_traits<T>::value_type>(output_range<T>{rb, re}, std::move(l));}
+template<typename T>
+inline detail::list_replace_2<typename std::iterator_traits<T>::value_type> replacer(const T& rb, const T& re, typename std::iterator_traits<T>::value_type t){return {output_range<T>{rb, re}, std::move(t)};}
+template<typename T, typename U>
+inline detail::list_replace_3<typename std::iterator_traits<T>::value_type, U> replacer(const T& rb, const T& re, const output_range<U>& r2){return {output_range<T>{rb, re}, r2};}
+template<typename T, typename U, typename Y>
+inline detail::list_replace_3<typename std::iterator_traits<T>::value_type, std::common_type_t<U, Y>> replacer(const T& rb, const T& re, const U& b, const Y& e){return replacer(rb, re, output_range<std::common_type_t<U, Y>>{b, e});}
+
+inline std::string escape(std::string_view str){
+  std::string ret;
+  for(auto&& x : str)
+    switch(x){
+      case '\t':ret += "\\t";break;
+      case '\'':ret += "\\\'";break;
+      case '"': ret += "\\\"";break;
+      case '\\':ret += "\\\\";break;
+      case '\a':ret += "\\a";break;
+      case '\b':ret += "\\b";break;
+      case '\f':ret += "\\f";break;
+      case '\n':ret += "\\n";break;
+      case '\r':ret += "\\r";break;
+      case '\v':ret += "\\v";break;
+      default:  ret += x;break;
+    }
+  return ret;
+}
+
+inline std::string unescape(std::string_view str){
+  static constexpr auto oct = veiler::pegasus::filter([](auto&& x, auto&&){return '0' <= *x && *x <= '8';})[([](auto&& x, [[maybe_unused]] auto&&... unused)->int{return *x - '0';})] >> veiler::pegasus::read[veiler::pegasus::semantic_actions::omit];
+  static constexpr auto hex = veiler::pegasus::filter([](auto&& x, auto&&){return '0' <= *x && *x <= '9';})[([](auto&& x, [[maybe_unused]] auto&&... unused)->int{return *x - '0';})] >> veiler::pegasus::read[veiler::pegasus::semantic_actions::omit]
+                            | veiler::pegasus::filter([](auto&& x, auto&&){return 'a' <= *x && *x <= 'f';})[([](auto&& x, [[maybe_unused]] auto&&... unused)->int{return *x - 'a'+10;})] >> veiler::pegasus::read[veiler::pegasus::semantic_actions::omit]
+                            | veiler::pegasus::filter([](auto&& x, auto&&){return 'A' <= *x && *x <= 'F';})[([](auto&& x, [[maybe_unused]] auto&&... unused)->int{return *x - 'A'+10;})] >> veiler::pegasus::read[veiler::pegasus::semantic_actions::omit];
+  std::string ret;
+  ret.reserve(str.size());
+  for(auto it = str.begin(); it != str.end();)
+    if(*it != '\\')
+      ret += *it++;
+    else if(it+1 != str.end())switch(*(it+1)){
+      case 't': ret += '\t';it += 2;break;
+      case '\'':ret += '\'';it += 2;break;
+      case '"':ret += '"';it += 2;break;
+      case '\\':ret += '\\';it += 2;break;
+      case '?': ret += '?';it += 2;break;
+      case 'a': ret += '\a';it += 2;break;
+      case 'b': ret += '\b';it += 2;break;
+      case 'f': ret += '\f';it += 2;break;
+      case 'n': ret += '\n';it += 2;break;
+      case 'r': ret += '\r';it += 2;break;
+      case 'v': ret += '\v';it += 2;break;
+      case 'x':{
+        int t = 0;
+        auto itt = it+2;
+        if(auto h = hex(itt, str.end()))
+          t = t*16+*h;
+        else
+          throw std::runtime_error("unescape: invalid \\x");
+        while(auto h = hex(itt, str.end()))
+          t = t*16+*h;
+        ret.push_back(static_cast<std::string::value_type>(t));
+        it = itt;
+      }break;
+      default:{
+        int t = 0;
+        auto itt = it+2;
+        if(auto h = oct(itt, str.end()))
+          t = t*8+*h;
+        else
+          throw std::runtime_error("unescape: invalid \\");
+        if(auto h = oct(itt, str.end())){
+          t = t*8+*h;
+           if(auto h = oct(itt, str.end()))
+             t = t*8+*h;
+        }
+        ret.push_back(static_cast<std::string::value_type>(t));
+        it = itt;
+      }
+    }
+  return ret;
+}
+
+template<typename T>
+inline std::string stringizer(const output_range<T>& r){
+  std::string str;
+  for(auto&& x : r)
+    if(x.type() == token_type::white_space
+    || x.type() == token_type::eol)
+      if(str.back() == ' ')
+        continue;
+      else
+        str += ' ';
+    else
+      if(x.type() == token_type::unclassified_character)
+        str += x.get();
+      else
+        str += escape(x.get());
+  return str;
+}
+template<typename T>
+inline std::string stringizer(const T& b, const T& e){
+  return stringizer(output_range<T>{b, e});
+}
+
+struct string_literal{
+  std::string str;
+  std::string suffix;//for UDL
+  enum class prefix{none, L, u, U, u8} is;
+  template<typename T>
+  static std::optional<string_literal> destringize(T&& token){
+    assert(token.type() == token_type::string_literal);
+    auto it = token.get().cbegin();
+    auto end = token.get().cend();
+    prefix is = prefix::none;
+    switch(*it){
+    case 'L':
+      is = prefix::L;
+      ++it;
+      break;
+    case 'u':
+      if(*(it+1) == '8')
+        is = prefix::u8, ++it;
+      else
+        is = prefix::u;
+      ++it;
+      break;
+    case 'U':
+      is = prefix::U;
+      ++it;
+      break;
+    default:;
+    }
+    const bool is_raw = *it == 'R';
+    if(is_raw)++it;
+    if(*it++ != '"')
+      return std::nullopt;
+    if(!is_raw){
+      while(*--end != '"');
+      return string_literal{unescape(std::string_view{&*it, static_cast<std::string_view::size_type>(end-it)}), std::string(end+1, token.get().cend()), is};
+    }
+    std::string delim;
+    while(*it != '(')
+      delim.push_back(*it++);
+    ++it;
+    end = it;
+    while(end != token.get().cend()){
+      if(*end == ')'){
+        std::string_view str{&*(end+1), delim.size()};
+        if(str == delim && *(end+1+delim.size()) == '"')
+          return string_literal{std::string(it, end), std::string(end+2+delim.size(), token.get().cend()), is};
+      }
+      ++end;
+    }
+    return std::nullopt;
+  }
+  phase3_t::value_type stringize(const annotation_type& anno)const{
+    std::string s;
+    switch(is){
+    case prefix::none:break;
+    case prefix::L:s.push_back('L');break;
+    case prefix::u:s.push_back('u');break;
+    case prefix::U:s.push_back('U');break;
+    case prefix::u8:s.push_back('u');s.push_back('8');break;
+    }
+    s.push_back('"');
+    s += escape(str);
+    s.push_back('"');
+    s += suffix;
+    return phase3_t::value_type{{std::move(s), token_type::string_literal}, anno};
+  }
+  string_literal& operator+=(const string_literal& rhs){
+    if(is == prefix::none)
+      is = rhs.is;
+    else if(rhs.is != prefix::none && is != rhs.is)
+      throw std::runtime_error("concat string literals failed (unmatch prefixes)");
+    if(suffix.empty())
+      suffix = rhs.suffix;
+    else if(!rhs.suffix.empty() && suffix != rhs.suffix)
+      throw std::runtime_error("concat string literals failed (unmatch user-defined literals)");
+    str += rhs.str;
+    return *this;
+  }
+};
+
+template<typename T>
+struct iterator_hasher : private std::hash<typename std::iterator_traits<T>::pointer>, std::hash<typename std::iterator_traits<T>::value_type>{
+  iterator_hasher() = default;
+  iterator_hasher(const iterator_hasher&) = default;
+  iterator_hasher(iterator_hasher&&) = default;
+  ~iterator_hasher() = default;
+  iterator_hasher& operator=(const iterator_hasher&) = default;
+  iterator_hasher& operator=(iterator_hasher&&) = default;
+  std::size_t operator()(T key)const{return veiler::detail::fool::hash_combine(static_cast<const std::hash<typename std::iterator_traits<T>::pointer>*>(this)->operator()(std::addressof(*key)), static_cast<const std::hash<typename std::iterator_traits<T>::value_type>*>(this)->operator()(*key));}
+  using result_type = std::size_t;
+  using argument_type = T;
+};
+
+}
+
+namespace std{
+
+template<>
+struct hash<messer::phase3_t::value_type> : hash<string>{
+  using result_type = std::size_t;
+  using argument_type = messer::phase3_t::value_type;
+  std::size_t operator()(const argument_type& key)const{return static_cast<const hash<string>*>(this)->operator()(key.get());}
+};
+
+}
+
+#include<sstream>
+#include<numeric>
+#include<chrono>
+#include<memory>
+#include<map>
+#include<set>
+#include<iomanip>
+#include<functional>
+#include<cstdint>
+#include<cctype>
+#include<cstdio>
+#include<ctime>
+#include<mutex>
+#include<condition_variable>
+#include<thread>
+#include<deque>
+#include<unordered_set>
+#include<atomic>
+#include<array>
+
+namespace messer{
+
+inline std::string json_escape(std::string_view str){
+  std::string ret;
+  for(auto&& x : str)
+    switch(x){
+      case '"': ret += "\\\"";break;
+      case '\\':ret += "\\\\";break;
+      case '\n':ret += "\\n";break;
+      case '\t':ret += "\\t";break;
+      default:
+        if(static_cast<unsigned char>(x) < 0x20){
+          static constexpr char hex[] = "0123456789abcdef";
+          ret += "\\u00";
+          ret += hex[(x >> 4) & 0xf];
+          ret += hex[x & 0xf];
+        }
+        else
+          ret += x;
+    }
+  return ret;
+}
+
+class expansion_profiler{
+ public:
+  using clock = std::chrono::steady_clock;
+  struct statistics{
+    std::size_t count = 0;
+    clock::duration inclusive{};
+    clock::duration exclusive{};
+    clock::duration arguments{};
+    std::size_t tokens = 0;
+    std::size_t max_depth = 0;
+    std::size_t active = 0;
+  };
+  struct node{
+    std::string name;
+    statistics stats;
+    std::map<std::string, std::unique_ptr<node>, std::less<>> children;
+    node* child(std::string_view n){
+      auto it = children.find(n);
+      if(it == children.end())
+        it = children.emplace(std::string{n}, std::make_unique<node>(node{std::string{n}, {}, {}})).first;
+      return it->second.get();
+    }
+  };
+ private:
+  struct frame{
+    node* call;
+    statistics* flat;
+    clock::time_point start;
+    clock::duration children;
+    std::size_t tokens;
+  };
+  std::unordered_map<std::string, statistics> flat;
+  node root{"<root>", {}, {}};
+  std::vector<frame> stack;
+  static double to_ms(clock::duration d){return std::chrono::duration<double, std::milli>(d).count();}
+  static auto to_ns(clock::duration d){return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();}
+  static void add(statistics& s, const frame& f, clock::duration inclusive, std::size_t depth){
+    ++s.count;
+    if(--s.active == 0)
+      s.inclusive += inclusive;
+    s.exclusive += inclusive - f.children;
+    s.tokens += f.tokens;
+    s.max_depth = std::max(s.max_depth, depth);
+  }
+ public:
+  void enter(std::string_view name){
+    node* parent = stack.empty() ? &root : stack.back().call;
+    auto& s = flat[std::string{name}];
+    auto* n = parent->child(name);
+    ++s.active;
+    ++n->stats.active;
+    stack.push_back(frame{n, &s, clock::now(), {}, 0});
+  }
+  void produced(std::size_t tokens){
+    if(!stack.empty())
+      stack.back().tokens = tokens;
+  }
+  void leave(){
+    const auto now = clock::now();
+    const auto f = stack.back();
+    stack.pop_back();
+    const auto inclusive = now - f.start;
+    add(*f.flat, f, inclusive, stack.size()+1);
+    add(f.call->stats, f, inclusive, stack.size()+1);
+    if(!stack.empty())
+      stack.back().children += inclusive;
+  }
+  void arguments(clock::duration d){
+    if(stack.empty())
+      return;
+    stack.back().flat->arguments += d;
+    stack.back().call->stats.arguments += d;
+  }
+  class scope{
+    expansion_profiler* p;
+   public:
+    scope(expansion_profiler* p, std::string_view name):p{p}{if(p)p->enter(name);}
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+    ~scope(){if(p)p->leave();}
+    void produced(std::size_t tokens){if(p)p->produced(tokens);}
+  };
+  class argument_scope{
+    expansion_profiler* p;
+    clock::time_point start;
+   public:
+    explicit argument_scope(expansion_profiler* p):p{p}, start{p ? clock::now() : clock::time_point{}}{}
+    argument_scope(const argument_scope&) = delete;
+    argument_scope& operator=(const argument_scope&) = delete;
+    ~argument_scope(){if(p)p->arguments(clock::now() - start);}
+  };
+  void write_text(std::ostream& os)const{
+    std::vector<std::pair<std::string_view, const statistics*>> sorted;
+    sorted.reserve(flat.size());
+    for(auto&& x : flat)
+      sorted.emplace_back(x.first, &x.second);
+    std::sort(sorted.begin(), sorted.end(), [](auto&& lhs, auto&& rhs){return lhs.second->exclusive > rhs.second->exclusive;});
+    const auto flags = os.flags();
+    os << std::fixed << std::setprecision(3)
+       << std::setw(10) << "calls" << std::setw(12) << "incl(ms)" << std::setw(12) << "excl(ms)" << std::setw(12) << "args(ms)" << std::setw(10) << "tokens" << std::setw(7) << "depth" << "  macro\n";
+    for(auto&& [name, s] : sorted)
+      os << std::setw(10) << s->count << std::setw(12) << to_ms(s->inclusive) << std::setw(12) << to_ms(s->exclusive) << std::setw(12) << to_ms(s->arguments) << std::setw(10) << s->tokens << std::setw(7) << s->max_depth << "  " << name << '\n';
+    os << "\ncall tree:\n";
+    const auto tree = [&os](auto&& self, const node& n, std::size_t indent)->void{
+      for(auto&& [name, c] : n.children){
+        os << std::string(indent*2, ' ') << name << "  calls=" << c->stats.count << " incl=" << to_ms(c->stats.inclusive) << "ms excl=" << to_ms(c->stats.exclusive) << "ms tokens=" << c->stats.tokens << '\n';
+        self(self, *c, indent+1);
+      }
+    };
+    tree(tree, root, 1);
+    os.flags(flags);
+  }
+  void write_json(std::ostream& os)const{
+    const auto stats = [&os](const statistics& s){
+      os << "\"calls\":" << s.count
+         << ",\"inclusive_ns\":" << to_ns(s.inclusive)
+         << ",\"exclusive_ns\":" << to_ns(s.exclusive)
+         << ",\"arguments_ns\":" << to_ns(s.arguments)
+         << ",\"tokens\":" << s.tokens
+         << ",\"max_depth\":" << s.max_depth;
+    };
+    os << "{\"macros\":[";
+    bool first = true;
+    for(auto&& [name, s] : flat){
+      os << (std::exchange(first, false) ? "" : ",") << "{\"name\":\"" << json_escape(name) << "\",";
+      stats(s);
+      os << '}';
+    }
+    os << "],\"tree\":";
+    const auto tree = [&](auto&& self, const node& n)->void{
+      os << "{\"name\":\"" << json_escape(n.name) << "\",";
+      stats(n.stats);
+      os << ",\"children\":[";
+      bool first = true;
+      for(auto&& x : n.children){
+        if(!std::exchange(first, false))
+          os << ',';
+        self(self, *x.second);
+      }
+      os << "]}";
+    };
+    tree(tree, root);
+    os << "}\n";
+  }
+};
+
+// counters of the work done by each phase, collected per translation unit
+struct runtime_statistics{
+  // bytes of the lexed tokens, after line splicing
+  std::size_t bytes = 0;
+  std::array<std::size_t, static_cast<std::size_t>(token_type::END)> tokens{};
+  std::size_t files_loaded = 0;
+  std::size_t file_cache_hits = 0;
+  std::size_t include_lookups = 0;
+  std::size_t include_lookup_hits = 0;
+  std::size_t macros_defined = 0;
+  std::size_t macros_undefined = 0;
+  std::size_t object_expansions = 0;
+  std::size_t function_expansions = 0;
+  std::size_t memoized_expansions = 0;
+  std::size_t pastes = 0;
+  std::size_t stringizations = 0;
+  std::size_t hide_set_updates = 0;
+  std::size_t if_evaluations = 0;
+  std::size_t files_evicted = 0;
+  // the most tokens one macro expansion produced
+  std::size_t peak_list_length = 0;
+  void lexed(const std::list<phase3_t::value_type>& ls){
+    for(auto&& x : ls){
+      bytes += x.get().size();
+      ++tokens[static_cast<std::size_t>(x.type())];
+    }
+  }
+  void produced(std::size_t length){
+    peak_list_length = std::max(peak_list_length, length);
+  }
+  std::vector<std::pair<std::string_view, std::size_t>> counters()const{
+    return {
+      {"bytes", bytes},
+      {"files_loaded", files_loaded},
+      {"file_cache_hits", file_cache_hits},
+      {"include_lookups", include_lookups},
+      {"include_lookup_hits", include_lookup_hits},
+      {"macros_defined", macros_defined},
+      {"macros_undefined", macros_undefined},
+      {"object_expansions", object_expansions},
+      {"function_expansions", function_expansions},
+      {"memoized_expansions", memoized_expansions},
+      {"pastes", pastes},
+      {"stringizations", stringizations},
+      {"hide_set_updates", hide_set_updates},
+      {"if_evaluations", if_evaluations},
+      {"files_evicted", files_evicted},
+      {"peak_list_length", peak_list_length},
+    };
+  }
+  void write_text(std::ostream& os)const{
+    for(auto&& [name, value] : counters())
+      os << std::setw(12) << value << "  " << name << '\n';
+    os << "\ntokens:\n";
+    for(std::size_t i = 0; i < tokens.size(); ++i)
+      if(tokens[i])
+        os << std::setw(12) << tokens[i] << "  " << static_cast<token_type>(i) << '\n';
+  }
+  void write_json(std::ostream& os)const{
+    os << '{';
+    for(auto&& [name, value] : counters())
+      os << '"' << name << "\":" << value << ',';
+    os << "\"tokens\":{";
+    bool first = true;
+    for(std::size_t i = 0; i < tokens.size(); ++i)
+      if(tokens[i])
+        os << (std::exchange(first, false) ? "" : ",") << '"' << static_cast<token_type>(i) << "\":" << tokens[i];
+    os << "}}";
+  }
+};
+
+// bytes held by each part of the preprocessor state, estimated from the sizes and capacities of the containers
+struct memory_usage{
+  // token lists of included files and streamed sources
+  std::size_t files = 0;
+  // entries of the macro tables and their replacement lists
+  std::size_t macros = 0;
+  // hide sets of the largest expansion so far
+  std::size_t hide_sets = 0;
+  // memoized expansions, expanded object-like macros, resolved includes and spare list nodes
+  std::size_t caches = 0;
+  // tokens produced by the largest expansion so far
+  std::size_t temporaries = 0;
+  static constexpr std::size_t list_node = 2 * sizeof(void*) + sizeof(phase3_t::value_type);
+  //nodes of unordered containers hold the next pointer and the hash besides the value
+  static constexpr std::size_t hash_node = sizeof(void*) + sizeof(std::size_t);
+  static std::size_t of(const std::string& s){
+    //short strings are stored in place
+    return s.capacity() > std::string{}.capacity() ? s.capacity() + 1 : 0;
+  }
+  static std::size_t of(const phase3_t::value_type& t){return of(t.get());}
+  template<typename T>
+  static std::size_t of(const std::vector<T>& v){
+    std::size_t ret = v.capacity() * sizeof(T);
+    if constexpr(!std::is_trivially_copyable_v<T>)
+      for(auto&& x : v)
+        ret += of(x);
+    return ret;
+  }
+  static std::size_t of(const std::list<phase3_t::value_type>& ls){
+    std::size_t ret = ls.size() * list_node;
+    for(auto&& x : ls)
+      ret += of(x);
+    return ret;
+  }
+  template<typename Map, typename F>
+  static std::size_t of(const Map& m, F&& f){
+    std::size_t ret = m.bucket_count() * sizeof(void*) + m.size() * (hash_node + sizeof(typename Map::value_type));
+    for(auto&& x : m)
+      ret += f(x);
+    return ret;
+  }
+  std::size_t total()const{return files + macros + hide_sets + caches + temporaries;}
+  std::vector<std::pair<std::string_view, std::size_t>> parts()const{
+    return {
+      {"files", files},
+      {"macros", macros},
+      {"hide_sets", hide_sets},
+      {"caches", caches},
+      {"temporaries", temporaries},
+      {"total", total()},
+    };
+  }
+  void peak(const memory_usage& m){
+    files = std::max(files, m.files);
+    macros = std::max(macros, m.macros);
+    hide_sets = std::max(hide_sets, m.hide_sets);
+    caches = std::max(caches, m.caches);
+    temporaries = std::max(temporaries, m.temporaries);
+  }
+  void write_text(std::ostream& os)const{
+    for(auto&& [name, value] : parts())
+      os << std::setw(12) << value << "  " << name << '\n';
+  }
+  void write_json(std::ostream& os)const{
+    os << '{';
+    bool first = true;
+    for(auto&& [name, value] : parts())
+      os << (std::exchange(first, false) ? "" : ",") << '"' << name << "\":" << value;
+    os << '}';
+  }
+};
+
+// shares one `T` between copies until one of them is modified
+template<typename T>
+class copy_on_write{
+  std::shared_ptr<T> ptr = std::make_shared<T>();
+ public:
+  const T& operator*()const noexcept{return *ptr;}
+  const T* operator->()const noexcept{return ptr.get();}
+  bool shares(const copy_on_write& other)const noexcept{return ptr == other.ptr;}
+  T& write(){
+    if(ptr.use_count() > 1)
+      ptr = std::make_shared<T>(std::as_const(*ptr));
+    else
+      //the other owners may have released it on other threads
+      std::atomic_thread_fence(std::memory_order_acquire);
+    return *ptr;
+  }
+};
+
+// tokens stored as parallel arrays, each spelling is a slice of one buffer
+class token_table{
+  static_assert(static_cast<std::underlying_type_t<token_type>>(token_type::END) <= 256);
+  std::vector<std::uint8_t> kinds;
+  std::vector<std::uint32_t> offsets{0};
+  std::vector<std::uint32_t> lines;
+  std::vector<std::uint32_t> columns;
+  std::string spellings;
+  std::string_view filename_;
+ public:
+  using token_t = phase3_t::value_type;
+  explicit token_table(std::string_view filename = {}):filename_{filename}{}
+  token_table(std::string_view filename, const std::list<token_t>& ls):filename_{filename}{
+    std::size_t bytes = 0;
+    for(auto&& x : ls)
+      bytes += x.get().size();
+    kinds.reserve(ls.size());
+    offsets.reserve(ls.size() + 1);
+    lines.reserve(ls.size());
+    columns.reserve(ls.size());
+    spellings.reserve(bytes);
+    for(auto&& x : ls)
+      push_back(x);
+  }
+  std::size_t size()const{return kinds.size();}
+  token_type kind(std::size_t i)const{return static_cast<token_type>(kinds[i]);}
+  std::string_view spelling(std::size_t i)const{return std::string_view{spellings}.substr(offsets[i], offsets[i+1] - offsets[i]);}
+  std::size_t line(std::size_t i)const{return lines[i];}
+  std::size_t column(std::size_t i)const{return columns[i];}
+  std::string_view filename()const{return filename_;}
+  std::size_t capacity_bytes()const{
+    return kinds.capacity() + (offsets.capacity() + lines.capacity() + columns.capacity()) * sizeof(std::uint32_t) + spellings.capacity();
+  }
+  void push_back(const token_t& t){
+    kinds.push_back(static_cast<std::uint8_t>(t.type()));
+    spellings += t.get();
+    offsets.push_back(static_cast<std::uint32_t>(spellings.size()));
+    lines.push_back(static_cast<std::uint32_t>(t.line()));
+    columns.push_back(static_cast<std::uint32_t>(t.column()));
+  }
+  // tokens [first, last) in the form the evaluator works on
+  std::list<token_t> tokens(std::size_t first, std::size_t last)const{
+    std::list<token_t> ret;
+    for(auto i = first; i < last; ++i)
+      ret.emplace_back(token<std::string>{std::string{spelling(i)}, kind(i)}, annotation_type{filename_, lines[i], columns[i]});
+    return ret;
+  }
+  // index of the '#' of the first directive line in [first, last), or last
+  std::size_t find_directive(std::size_t first, std::size_t last)const{
+    for(auto i = first; i < last; ++i){
+      if(kind(i) != token_type::eol)
+        continue;
+      auto j = i + 1;
+      while(j < last && kind(j) == token_type::white_space)
+        ++j;
+      if(j < last && kind(j) == token_type::punctuator_hash)
+        return j;
+    }
+    return last;
+  }
+};
+
+class phase4_t{
+ public:
+  using token_t = phase3_t::value_type;
+
+  phase4_t() = default;
+  // shares the include directories, macros and caches of `base` until either is modified
+  explicit phase4_t(const phase4_t* base);
+  using filepath = std::filesystem::path;
+  std::vector<filepath> system_include_dir;
+  std::vector<filepath>        include_dir;
+  // the tokens of included files, evaluated on a list made from them since evaluation replaces the macro invocations in place
+  std::unordered_map<std::string, std::shared_ptr<const token_table>> files;
+  // evaluates only the directives of included files, see minimize_directives
+  bool directives_only = false;
+  std::unordered_map<std::string, std::shared_ptr<const token_table>> directive_files;
+  // every file included so far, in order of inclusion
+  std::vector<std::string> included;
+  // results of resolve_include keyed by the including directory and the header name
+  copy_on_write<std::unordered_map<std::string, std::optional<std::filesystem::path>>> include_paths;
+  // the state this one is a snapshot of, it must not change while the snapshot is in use
+  const phase4_t* base = nullptr;
+  // a file included by the streaming mode, split into logical lines which are lexed when they are first needed
+  struct source_file{
+    struct line{
+      // released once the line is lexed
+      std::string text;
+      std::size_t newlines;
+      bool directive;
+      bool lexed = false;
+      // the tokens of the line in `table`
+      std::size_t first = 0;
+      std::size_t last = 0;
+    };
+    std::vector<line> lines;
+    token_table table;
+    source_file(std::istream& is, std::string_view filename);
+    std::list<token_t> tokens(std::size_t index, std::size_t number);
+    std::size_t capacity_bytes()const{
+      std::size_t ret = table.capacity_bytes() + lines.capacity() * sizeof(line);
+      for(auto&& x : lines)
+        ret += memory_usage::of(x.text);
+      return ret;
+    }
+  };
+  std::unordered_map<std::string, source_file> sources;
+  // sizes of the cached lists of `files`, `directive_files` and `sources`, the least recently included first, kept only while the capacity is bounded
+  struct file_cache_usage{
+    enum class kind{file, directive_file, source};
+    using key = std::pair<kind, std::string>;
+    std::list<key> order;
+    std::map<key, std::pair<std::list<key>::iterator, std::size_t>> entries;
+    std::size_t bytes = 0;
+    // `size` is required when `path` is newly cached, and keeps the recorded one when omitted
+    void touch(kind k, const std::string& path, std::optional<std::size_t> size = std::nullopt){
+      key x{k, path};
+      auto it = entries.find(x);
+      if(it == entries.end())
+        it = entries.emplace(x, std::make_pair(order.insert(order.end(), x), std::size_t{0})).first;
+      else
+        order.splice(order.end(), order, it->second.first);
+      if(!size)
+        return;
+      bytes = bytes - it->second.second + *size;
+      it->second.second = *size;
+    }
+  };
+  file_cache_usage file_usage;
+  // evict_files releases the least recently included lists until the cached files fit in it
+  std::size_t file_cache_capacity = static_cast<std::size_t>(-1);
+  bool file_cache_bounded()const{return file_cache_capacity != static_cast<std::size_t>(-1);}
+  // starts recording the sizes of the cached files when it becomes bounded, and evicts
+  void set_file_cache_capacity(std::size_t bytes);
+  void evict_files();
+  std::set<std::string, std::less<>> filenames;
+  std::string_view intern(std::string_view filename){
+    auto it = filenames.find(filename);
+    if(it == filenames.end())
+      it = filenames.emplace(filename).first;
+    return *it;
+  }
+  // a replacement list in the tokens it keeps alive, which every macro with the same replacement list shares
+  struct replacement_list : output_range<std::list<token_t>::const_iterator>{
+    std::shared_ptr<const std::list<token_t>> tokens;
+    replacement_list() = default;
+    replacement_list(const output_range<std::list<token_t>::const_iterator>& r, std::shared_ptr<const std::list<token_t>> t = nullptr):output_range{r}, tokens{std::move(t)}{}
+  };
+  // the replacement lists defined by this state keyed by their tokens, expired ones are swept once it doubles
+  std::unordered_map<std::string, std::weak_ptr<const std::list<token_t>>> replacement_lists;
+  std::size_t replacement_lists_sweep = 64;
+  // a copy of `r` which does not refer to the list `r` is in
+  replacement_list own(const output_range<std::list<token_t>::const_iterator>& r);
+  using object_table = std::unordered_map<std::string, replacement_list>;
+  copy_on_write<object_table> objects;
+  struct func_t{
+    int arg_num;
+    std::vector<int> arg_index;
+    replacement_list dst;
+  };
+  using function_table = std::unordered_map<std::string, func_t>;
+  copy_on_write<function_table> functions;
+  std::unique_ptr<expansion_profiler> profiler;
+  std::function<void(std::string_view)> step_trace;
+  // receives the messages of failures which do not stop preprocessing, they are dropped when it is empty
+  std::function<void(std::string_view)> diagnostic;
+  // bodies of _Pragma operators, evaluated once the line they appear in is expanded
+  mutable std::vector<std::string> pragmas;
+  using hide_set_map = std::unordered_map<std::list<token_t>::const_iterator, std::vector<std::string>, iterator_hasher<std::list<token_t>::const_iterator>>;
+  class token_pool;
+  // results of function-like macro invocations, cleared by #define and #undef
+  struct expansion_memo{
+    struct entry{
+      std::list<token_t> tokens;
+      std::vector<std::vector<std::string>> replaced;
+      // index of the invocation token whose annotation the token takes, -1 for the macro name
+      std::vector<std::ptrdiff_t> origin;
+    };
+    static constexpr std::size_t max_entries = 1 << 16;
+    // counts expansions which depend on more than the invocation tokens (__LINE__, _Pragma, ...)
+    std::size_t volatile_expansions = 0;
+    std::unordered_map<std::string, entry> entries;
+    // consulted after `entries` until the first invalidation
+    const expansion_memo* base = nullptr;
+    static std::string key(std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, const hide_set_map& replaced);
+    const entry* find(const std::string& key)const;
+    static std::list<token_t> load(const entry& e, std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, hide_set_map& replaced, token_pool& pool);
+    void store(std::string&& key, std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, const std::list<token_t>& expanded, const hide_set_map& replaced);
+    void invalidate(){entries.clear();base = nullptr;}
+  };
+  mutable expansion_memo memo;
+  // fully expanded object-like macros with the macro names their expansion looked up
+  struct object_expansion_cache{
+    struct entry{
+      // false when the expansion may depend on the context it is expanded in
+      bool closed;
+      std::list<token_t> tokens;
+      std::vector<std::vector<std::string>> replaced;
+      std::vector<std::string> dependencies;
+    };
+    struct not_closed{};
+    struct recorder{
+      object_expansion_cache& cache;
+      std::vector<std::string>* saved;
+      recorder(object_expansion_cache& c, std::vector<std::string>& deps):cache{c}, saved{c.recording}{cache.recording = &deps;}
+      ~recorder(){cache.recording = saved;}
+    };
+    std::unordered_map<std::string, entry> entries;
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+    // consulted after `entries` until a macro one of its entries depends on changes
+    const object_expansion_cache* base = nullptr;
+    std::vector<std::string>* recording = nullptr;
+    void record(const std::string& name){
+      if(recording)
+        recording->emplace_back(name);
+    }
+    const entry* find(const std::string& name)const;
+    void store(const std::string& name, entry& slot, entry&& e);
+    void invalidate(const std::string& name);
+    void clear(){entries.clear();dependents.clear();base = nullptr;}
+  };
+  mutable object_expansion_cache object_cache;
+  // the macro tables at some point, cheap to take since the tables are shared until modified
+  struct checkpoint{
+    copy_on_write<object_table> objects;
+    copy_on_write<function_table> functions;
+  };
+  checkpoint save()const{return {objects, functions};}
+  void rollback(checkpoint&& c){
+    objects = std::move(c.objects);
+    functions = std::move(c.functions);
+    memo.invalidate();
+    object_cache.clear();
+    pragmas.clear();
+  }
+  // function-like macro invocations whose arguments are being expanded
+  struct expansion_frame{
+    virtual ~expansion_frame() = default;
+    // returns false once the invocation has been replaced in its parent list
+    virtual bool resume() = 0;
+  };
+  struct expansion_stack{
+    std::vector<std::unique_ptr<expansion_frame>> frames;
+    // set while a frame scans its argument, invocations found there are pushed instead of expanded in place
+    bool driven = false;
+  };
+  mutable expansion_stack expansions;
+  struct pp_state{
+    std::list<token_t>& list;
+    hide_set_map replaced;
+    // set whenever a replacement is made in `list`
+    bool dirty = false;
+  };
+  // list nodes of replaced tokens, reused by the following copies instead of allocating new ones
+  class token_pool{
+    std::list<token_t> spare;
+   public:
+    static constexpr std::size_t max_size = 1 << 14;
+    std::size_t spares()const{return spare.size();}
+    template<typename Iterator>
+    std::list<token_t> copy(Iterator first, Iterator last){
+      std::list<token_t> ret;
+      for(; first != last && !spare.empty(); ++first){
+        ret.splice(ret.end(), spare, spare.begin());
+        ret.back() = *first;
+      }
+      ret.insert(ret.end(), first, last);
+      return ret;
+    }
+    // as replacer(first, last, data) on `ps.list`, the replaced nodes lose their hide sets and are kept for reuse
+    output_range<std::list<token_t>::iterator> replace(pp_state& ps, std::list<token_t>::const_iterator first, std::list<token_t>::const_iterator last, std::list<token_t>&& data){
+      const auto inserted_begin = data.empty() ? ps.list.erase(last, last) : data.begin();
+      ps.list.splice(first, data);
+      for(auto it = first; it != last; ++it)
+        ps.replaced.erase(it);
+      if(spare.size() < max_size)
+        spare.splice(spare.begin(), ps.list, first, last);
+      else
+        ps.list.erase(first, last);
+      return {inserted_begin, ps.list.erase(last, last)};
+    }
+  };
+  mutable token_pool pool;
+  mutable runtime_statistics stats;
+  // the hide sets and temporaries of memory(), updated when eval returns
+  memory_usage transient_memory;
+  // the tables a snapshot still shares with its base are counted by the base only
+  memory_usage memory()const;
+  // starts a translation unit, forgetting the included files, counters and peak memory of the last one
+  void begin_unit(){
+    included.clear();
+    stats = {};
+    transient_memory = {};
+  }
+  template<typename T>
+  static constexpr auto _(T&& t){return veiler::pegasus::lit(std::forward<T>(t))[veiler::pegasus::semantic_actions::omit];}
+  struct passed_identity_t{
+    constexpr passed_identity_t() = default;
+    template<typename T>
+    constexpr bool operator()(T&&)const{return true;}
+  }static constexpr passed_identity = {};
+  struct no_yield_t{
+    constexpr no_yield_t() = default;
+    template<typename... Args>
+    constexpr void operator()(Args&&...)const noexcept{}
+  }static constexpr no_yield = {};
+  struct eval_macro_t{
+    constexpr eval_macro_t() = default;
+    static std::tm local_time(const std::chrono::system_clock::time_point& time){
+      const auto t = std::chrono::system_clock::to_time_t(time);
+      std::tm tm{};
+      localtime_r(&t, &tm);
+      return tm;
+    }
+    //formatted by hand since the month names of strftime follow the global locale
+    static std::string time(){
+      const auto tm = local_time(std::chrono::system_clock::now());
+      char str[32];
+      std::snprintf(str, sizeof(str), "%02d:%02d:%02d", tm.tm_hour, tm.tm_min, tm.tm_sec);
+      return str;
+    }
+    static std::string date(){
+      static constexpr const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+      const auto tm = local_time(std::chrono::system_clock::now());
+      char str[32];
+      std::snprintf(str, sizeof(str), "%s %2d %d", months[tm.tm_mon], tm.tm_mday, tm.tm_year + 1900);
+      return str;
+    }
+    template<typename T, typename U, typename V>
+    static auto cat_token(T&& prev, U&& next, V&& hashhash){
+      if(prev.type() == token_type::empty)
+        return next;
+      if(next.type() == token_type::empty)
+        return prev;
+      const auto range = lex_pasted(prev.get() + next.get(), prev.annotation());
+      if(range.size() != 2){
+        std::string message = std::string{hashhash->filename()} + ':' + std::to_string(hashhash->line()) + ':' + std::to_string(hashhash->column()) + ": error: operator ## makes invalid token";
+        const auto f = [](auto t){
+          std::stringstream ss;
+          ss << t;
+          return ss.str();
+        };
+        for(auto it = std::next(range.begin()); it != range.end(); ++it)
+          message += "\n  " + std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": " + it->get() + '(' + f(it->type()) + ")";
+        throw std::runtime_error(std::move(message));
+      }
+      auto t = *std::next(range.begin());
+      if(t.type() == token_type::punctuator_hash || t.type() == token_type::punctuator_hashhash)
+        return token_t{token<std::string>{t.get(), token_type::punctuator}, t.annotation()};
+      return t;
+    }
+    //the first non white space token, nullopt when the sentinel is reached
+    template<typename Iterator, typename F>
+    static std::optional<Iterator> search_(Iterator it, Iterator sentinel, F&& f){
+      if(it == sentinel)
+        return std::nullopt;
+      do{
+        f(it);
+        if(it == sentinel)
+          return std::nullopt;
+      }while(is_white_spaces(it->type()));
+      return it;
+    }
+    template<typename Hash>
+    static auto apply_cat(Hash&& hashhash, pp_state& pps){
+      static constexpr auto search = [](const auto& it, auto sentinel, auto&& f){
+        if(auto found = search_(it, std::move(sentinel), f))
+          return *found;
+        throw std::runtime_error(std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: operator ## can't receive parameter(search_parameter reach edge)");
+      };
+      const auto prev = search(hashhash, pps.list.begin(), [](auto&& it){--it;});
+      auto next = search(hashhash, pps.list.end(), [](auto&& it){++it;});
+      const auto replaced_pos = pps.list.insert(prev, cat_token(*prev, *next, hashhash));
+      ++next;
+      for(auto it = prev; it != next; ++it)
+        pps.replaced.erase(it);
+      pps.list.erase(prev, next);
+      return replaced_pos;
+    }
+    template<typename Iterator, typename End>
+    static bool replace_invocation(const phase4_t& state, pp_state& tmp_state, Iterator&& it, const End& arg_it, std::list<token_t>&& copy){
+      //placemarkers only come from the replacement list of this invocation
+      for(auto i = copy.begin(); i != copy.end();)
+        if(i->type() == token_type::empty){
+          if(auto ri = tmp_state.replaced.find(i); ri != tmp_state.replaced.end())
+            tmp_state.replaced.erase(ri);
+          i = copy.erase(i);
+        }
+        else
+          ++i;
+      auto replaced = state.pool.replace(tmp_state, it, arg_it, std::move(copy));
+      tmp_state.dirty = true;
+      it = replaced.begin();
+      return true;
+    }
+    const object_expansion_cache::entry& expand_object(const object_table::const_iterator& object_it, const phase4_t& state)const{
+      auto& cache = state.object_cache;
+      const auto found = cache.entries.find(object_it->first);
+      if(found == cache.entries.end() && cache.base)
+        if(const auto inherited = cache.base->find(object_it->first)){
+          if(cache.recording)
+            cache.recording->insert(cache.recording->end(), inherited->dependencies.begin(), inherited->dependencies.end());
+          return *inherited;
+        }
+      auto& slot = found != cache.entries.end() ? found->second : [&]()->object_expansion_cache::entry&{
+        //placeholder for macros reached again while their expansion is computed
+        auto& slot = cache.entries.emplace(object_it->first, object_expansion_cache::entry{false, {}, {}, {object_it->first}}).first->second;
+        object_expansion_cache::entry e{false, {}, {}, {object_it->first}};
+        try{
+          object_expansion_cache::recorder _{cache, e.dependencies};
+          std::list<token_t> list(object_it->second.begin(), object_it->second.end());
+          list.push_front({{"", token_type::empty}, {}});
+          pp_state ps{list, {}};
+          for(auto it_ = std::next(list.begin()), end_ = list.end(); it_ != end_; ++it_)
+            if(it_->type() == token_type::punctuator_hashhash){
+              it_ = apply_cat(it_, ps);
+              ++state.stats.pastes;
+            }
+          list.pop_front();
+          for(auto it_ = list.cbegin(); it_ != list.cend(); ++it_)
+            ps.replaced[it_].emplace_back(object_it->first);
+          auto list_it = list.cbegin();
+          while((*this)(*this, passed_identity, state, ps, list_it, list.cend(), no_yield));
+          //an invocation which failed stops the scan early, the usual path reports it
+          const auto tail = std::find_if(list.rbegin(), list.rend(), [](auto&& t){return !is_white_spaces(t.type());});
+          e.closed = list_it == list.cend() && (tail == list.rend() || (tail->type() != token_type::identifier_pragma_op && state.functions->find(tail->get()) == state.functions->end()))
+                  && std::none_of(list.begin(), list.end(), [](auto&& t){return t.type() == token_type::identifier_defined || t.type() == token_type::identifier_has_include;});
+          if(e.closed){
+            for(auto it_ = list.cbegin(); it_ != list.cend(); ++it_){
+              const auto r = ps.replaced.find(it_);
+              e.replaced.emplace_back(r == ps.replaced.end() ? std::vector<std::string>{} : r->second);
+            }
+            e.tokens = std::move(list);
+          }
+        }catch(object_expansion_cache::not_closed&){
+          e.closed = false;
+        }catch(std::runtime_error&){
+          e.closed = false;
+        }
+        cache.store(object_it->first, slot, std::move(e));
+        return slot;
+      }();
+      if(cache.recording)
+        cache.recording->insert(cache.recording->end(), slot.dependencies.begin(), slot.dependencies.end());
+      return slot;
+    }
+    template<bool Step, typename Passed, typename Iterator, typename End, typename Yield>
+    auto object_macro_replace(const object_table::const_iterator& object_it, Passed&& passed, const phase4_t& state, pp_state& tmp_state, Iterator&& it, const End& end, Yield&& yield)const{
+      auto check_recur = tmp_state.replaced.find(it);
+      if(check_recur != tmp_state.replaced.end())
+        for(auto&& x : check_recur->second)
+          if(it->get() == x)
+            return passed(*it++);
+      expansion_profiler::scope profiling{state.profiler.get(), it->get()};
+      if constexpr(!Step){
+        const auto& expanded = expand_object(object_it, state);
+        const auto hidden = [&]{
+          if(check_recur == tmp_state.replaced.end())
+            return false;
+          for(auto&& x : check_recur->second)
+            if(std::find(expanded.dependencies.begin(), expanded.dependencies.end(), x) != expanded.dependencies.end())
+              return true;
+          return false;
+        };
+        if(expanded.closed && !hidden()){
+          const auto hide_set = check_recur != tmp_state.replaced.end() ? check_recur->second : std::vector<std::string>{};
+          auto copy = state.pool.copy(expanded.tokens.begin(), expanded.tokens.end());
+          std::size_t i = 0;
+          for(auto it_ = copy.begin(); it_ != copy.end(); ++it_, ++i){
+            it_->annotation() = it->annotation();
+            auto& r = tmp_state.replaced[it_];
+            r = hide_set;
+            r.insert(r.end(), expanded.replaced[i].begin(), expanded.replaced[i].end());
+          }
+          profiling.produced(copy.size());
+          ++state.stats.object_expansions;
+          state.stats.hide_set_updates += copy.size();
+          state.stats.produced(copy.size());
+          auto replaced = state.pool.replace(tmp_state, it, std::next(it), std::move(copy));
+          tmp_state.dirty = true;
+          it = replaced.end();
+          for(auto&& x : replaced)
+            if(!passed(x))
+              return false;
+          return true;
+        }
+      }
+      auto copy = state.pool.copy(object_it->second.begin(), object_it->second.end());
+      for(auto&& x : copy)
+        x.annotation() = it->annotation();
+      copy.push_front({{"", token_type::empty}, it->annotation()});
+      pp_state copy_state{copy, std::move(tmp_state.replaced)};
+      if constexpr(Step)
+        yield(state, copy_state, copy.begin(), {output_range<std::list<token_t>::const_iterator>{copy.begin(), copy.end()}, output_range<std::list<token_t>::const_iterator>{std::next(it), end}});
+      for(auto it_ = std::next(copy.begin()), end_ = copy.end(); it_ != end_; ++it_)
+        if(it_->type() == token_type::punctuator_hashhash){
+          it_ = apply_cat(it_, copy_state);
+          ++state.stats.pastes;
+          if constexpr(Step)
+            yield(state, copy_state, std::next(it_), {output_range<std::list<token_t>::const_iterator>{copy.begin(), copy.end()}, output_range<std::list<token_t>::const_iterator>{std::next(it), end}});
+        }
+      copy.pop_front();
+      profiling.produced(copy.size());
+      ++state.stats.object_expansions;
+      state.stats.hide_set_updates += copy.size();
+      state.stats.produced(copy.size());
+      for(auto it_ = copy.begin(), end_ = copy.end(); it_ != end_; ++it_){
+        if(check_recur != tmp_state.replaced.end())
+          copy_state.replaced[it_] = check_recur->second;
+        copy_state.replaced[it_].emplace_back(it->get());
+      }
+      tmp_state.replaced = std::move(copy_state.replaced);
+      auto replaced = state.pool.replace(tmp_state, it, std::next(it), std::move(copy));
+      tmp_state.dirty = true;
+      it = replaced.begin();
+      return true;
+    }
+    template<typename Passed, typename Iterator, typename End>
+    auto save_defined_argument(Passed&& passed, Iterator&& it, const End& end)const{
+      static constexpr auto identifier = veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return is_identifier(veiler::pegasus::member_access<token_type>(*v++));});
+      static constexpr auto arg_parser = (
+           veiler::pegasus::read //token_type::identifier_defined
+        >> ( ( _(token_type::punctuator_left_parenthesis)
+            >> identifier
+            >> _(token_type::punctuator_right_parenthesis)
+             )
+             | identifier
+           )
+      ).with_skipper(*veiler::pegasus::filter([](auto&& it, [[maybe_unused]] auto&&... unused){return is_white_spaces(veiler::pegasus::member_access<token_type>(*it++));}));
+      auto parse_result = arg_parser[veiler::pegasus::semantic_actions::location](it, end);
+      if(!parse_result)
+        return false;
+      for(auto&& x : *parse_result)
+        passed(x);
+      return true;
+    }
+    template<typename Passed, typename Iterator, typename End>
+    auto save_has_include_argument(Passed&& passed, Iterator&& it, const End& end)const{
+      static constexpr auto arg_parser = (
+           veiler::pegasus::read //token_type::identifier_has_include
+        >> _(token_type::punctuator_left_parenthesis)
+        >> ( _(token_type::header_name)
+           | _(token_type::string_literal)
+           | veiler::pegasus::lexeme[_(token_type::punctuator_less) >> *(veiler::pegasus::read - _(token_type::punctuator_greater)) >> _(token_type::punctuator_greater)]
+           )
+        >> _(token_type::punctuator_right_parenthesis)
+      ).with_skipper(*veiler::pegasus::filter([](auto&& it, [[maybe_unused]] auto&&... unused){return is_white_spaces(veiler::pegasus::member_access<token_type>(*it++));}));
+      auto parse_result = arg_parser[veiler::pegasus::semantic_actions::location](it, end);
+      if(!parse_result)
+        return false;
+      for(auto&& x : *parse_result)
+        passed(x);
+      return true;
+    }
+    struct expanded_argument{
+      std::list<token_t> tokens;
+      std::vector<std::pair<std::size_t, std::vector<std::string>>> replaced;
+    };
+    static void pull_out_hash(std::list<token_t>& list){
+      for(auto&& x : list)
+        if(x.type() == token_type::punctuator_hash || x.type() == token_type::punctuator_hashhash)
+          x.type() = token_type::punctuator;
+    }
+    // the state of a function-like macro invocation between the steps of phase4_t::expansions
+    template<bool InArithmeticEvaluation, bool Step, typename Iterator, typename Yield>
+    struct invocation : expansion_frame{
+      using const_iterator = std::list<token_t>::const_iterator;
+      using step_yield = std::function<void(const phase4_t&, pp_state&, const_iterator, std::vector<output_range<const_iterator>>)>;
+      struct argument{
+        std::list<token_t> list;
+        pp_state ps;
+        const_iterator list_it;
+        std::size_t index;
+        bool hidden_parameter;
+        std::optional<expanded_argument>* cache;
+        expansion_profiler::argument_scope profiling;
+        step_yield yield;
+        argument(token_pool& pool, const_iterator b, const_iterator e, hide_set_map&& replaced, std::size_t id, bool hidden, std::optional<expanded_argument>* c, expansion_profiler* p)
+          :list(pool.copy(b, e)), ps{list, std::move(replaced)}, list_it{}, index{id}, hidden_parameter{hidden}, cache{c}, profiling{p}{}
+      };
+      const eval_macro_t& self;
+      const phase4_t& state;
+      pp_state& parent;
+      Iterator& it;
+      Iterator arg_it;
+      const_iterator end;
+      Yield yield;
+      function_table::const_iterator f;
+      std::vector<output_range<const_iterator>> args;
+      std::vector<std::string> recur;
+      std::string memo_key;
+      std::size_t volatile_expansions;
+      std::size_t depth;
+      expansion_profiler::scope profiling;
+      std::list<token_t> copy;
+      pp_state copy_state;
+      std::size_t index = 0;
+      std::list<token_t>::iterator it_;
+      std::vector<std::optional<expanded_argument>> expanded_args;
+      std::optional<argument> current;
+      template<typename End, typename Y>
+      invocation(const eval_macro_t& em, const phase4_t& st, pp_state& tmp_state, Iterator& i, Iterator ai, const End& e, Y&& y, function_table::const_iterator fn, std::vector<output_range<const_iterator>>&& as, std::vector<std::string>&& rc, std::string&& key, std::size_t d)
+        :self{em}, state{st}, parent{tmp_state}, it{i}, arg_it{ai}, end{e}, yield{std::forward<Y>(y)}, f{fn}, args{std::move(as)}, recur{std::move(rc)}, memo_key{std::move(key)}, volatile_expansions{st.memo.volatile_expansions}, depth{d}, profiling{st.profiler.get(), i->get()}, copy(st.pool.copy(fn->second.dst.begin(), fn->second.dst.end())), copy_state{copy, {}}, expanded_args(Step ? 0 : args.size()){
+        for(auto&& x : copy)
+          x.annotation() = it->annotation();
+        {
+          auto p = parent.replaced.find(it);
+          if(p != parent.replaced.end()){
+            if(!recur.empty()){
+              for(auto itt = copy.begin(); itt != copy.end(); ++itt){
+                for(auto&& x : recur)
+                  if(x == itt->get())
+                    parent.replaced[itt].emplace_back(x);
+                parent.replaced[itt] = recur;//p->second;
+              }
+            }
+          }
+        }
+        copy.push_front({{"", token_type::empty}, it->annotation()});
+        copy_state.replaced = std::move(parent.replaced);
+        it_ = std::next(copy.begin());
+        trace(it_, index);
+      }
+      bool resume()override{
+        if(current && !expand_argument())
+          return true;
+        if(!substitute())
+          return true;
+        finish();
+        return false;
+      }
+      void trace(std::list<token_t>::iterator i, std::size_t id){
+        if constexpr(Step){
+          std::vector<output_range<const_iterator>> ret;
+          if(i != std::next(copy.begin()))
+            ret.emplace_back(std::next(copy.begin()), i);
+          auto b = i;
+          while(i != copy.end() && id < f->second.arg_index.size()){
+            const auto ai = f->second.arg_index[id];
+            if(ai != 0){
+              if(b != i)
+                ret.emplace_back(b, i);
+              b = std::next(i);
+            }
+            if(ai > 0)
+              ret.emplace_back(args[ai-1]);
+            else if(ai < 0)
+              ret.emplace_back(args[-ai-1].begin(), args.back().end());
+            ++i;
+            ++id;
+          }
+          if(b != i)
+            ret.emplace_back(b, i),
+            b = std::next(i);
+          ret.emplace_back(arg_it, end);
+          yield(state, copy_state, i, ret);
+        }
+      }
+      // the replacement list around the argument being expanded, for step traces
+      void trace_argument(std::vector<output_range<const_iterator>>& ret){
+        auto i = it_;
+        auto id = current->index;
+        if(i != copy.begin())
+          ret.emplace(ret.begin(), copy.begin(), i);
+        ++i;
+        ++id;
+        auto b = i;
+        while(i != copy.end()){
+          const auto ai = f->second.arg_index[id];
+          if(ai != 0){
+            if(b != i)
+              ret.emplace_back(b, i);
+            b = std::next(i);
+          }
+          if(ai > 0)
+            ret.emplace_back(args[ai-1]);
+          else if(ai < 0)
+            ret.emplace_back(args[-ai-1].begin(), args.back().end());
+          ++i;
+          ++id;
+        }
+        if(b != i)
+          ret.emplace_back(b, i);
+      }
+      void copy_insert(std::list<token_t>::iterator& i, const_iterator b, const_iterator e){
+        auto list = state.pool.copy(b, e);
+        if(!recur.empty())
+          for(auto itt = list.cbegin(); itt != list.cend(); ++itt)
+            copy_state.replaced[itt] = recur;
+        pull_out_hash(list);
+        if(b != e){
+          auto replaced = state.pool.replace(copy_state, i, std::next(i), std::move(list));
+          i = replaced.end();
+        }
+        else{
+          auto replaced = (copy|replacer(i, std::next(i), token_t{{"", token_type::empty}, b->annotation()}));
+          i = replaced.end();
+        }
+      }
+      void insert_expanded(const expanded_argument& e){
+        auto list = state.pool.copy(e.tokens.begin(), e.tokens.end());
+        {
+          auto itt = list.cbegin();
+          std::size_t i = 0;
+          for(auto&& [pos, hide_set] : e.replaced){
+            std::advance(itt, pos - i);
+            i = pos;
+            copy_state.replaced[itt] = hide_set;
+          }
+        }
+        auto replaced = state.pool.replace(copy_state, it_, std::next(it_), std::move(list));
+        it_ = replaced.end();
+      }
+      // returns false when the argument is left to be expanded by the following steps
+      bool substitute_argument(int ai){
+        const auto arg = ai < 0 ? -ai-1 : ai-1;
+        const auto b = args[arg].begin();
+        const auto e = ai < 0 ? args.back().end() : args[arg].end();
+        if(b == e){
+          copy_insert(it_, b, e);
+          return true;
+        }
+        std::optional<expanded_argument>* cache = nullptr;
+        if constexpr(!Step){
+          if(expanded_args[arg]){
+            insert_expanded(*expanded_args[arg]);
+            return true;
+          }
+          if(std::count(f->second.arg_index.begin(), f->second.arg_index.end(), ai) > 1)
+            cache = &expanded_args[arg];
+        }
+        const bool hidden_parameter = !recur.empty() && copy_state.replaced.find(it_) != copy_state.replaced.end();
+        auto& a = current.emplace(state.pool, b, e, std::move(copy_state.replaced), index, hidden_parameter, cache, state.profiler.get());
+        pull_out_hash(a.list);
+        for(auto itr = b, list_it = a.list.cbegin(); itr != e; ++list_it, ++itr){
+          const auto finded = a.ps.replaced.find(itr);
+          if(finded != a.ps.replaced.end()){
+            const auto& hide_set = finded->second;
+            a.ps.replaced[list_it] = hide_set;
+          }
+        }
+        if constexpr(Step)
+          a.yield = [this](const phase4_t& state_, pp_state& tmp_state_, const_iterator itr, std::vector<output_range<const_iterator>> list_){
+            if(current->list_it != current->list.cbegin())
+              list_.emplace(list_.begin(), current->list.cbegin(), current->list_it);
+            trace_argument(list_);
+            list_.emplace_back(arg_it, end);
+            yield(state_, tmp_state_, itr, std::move(list_));
+          };
+        begin_pass();
+        return false;
+      }
+      void begin_pass(){
+        auto& a = *current;
+        if(a.hidden_parameter)
+          for(auto itt = a.list.cbegin(); itt != a.list.cend(); ++itt){
+            if(std::any_of(a.ps.replaced[itt].begin(), a.ps.replaced[itt].end(), [&](auto&& t){return t == itt->get();}))
+              (a.ps.replaced[itt] = recur).emplace_back(itt->get());
+            else
+              a.ps.replaced[itt] = recur;
+          }
+        a.ps.dirty = false;
+        a.list_it = a.list.cbegin();
+      }
+      // rescans the argument until a pass makes no replacement, returns false when an invocation was pushed
+      bool expand_argument(){
+        auto& a = *current;
+        auto& frames = state.expansions.frames;
+        while(true){
+          while(true){
+            state.expansions.driven = true;
+            bool scanned;
+            if constexpr(Step)
+              scanned = self.template operator()<InArithmeticEvaluation, Step>(self, passed_identity, state, a.ps, a.list_it, a.list.cend(), a.yield);
+            else
+              scanned = self.template operator()<InArithmeticEvaluation, Step>(self, passed_identity, state, a.ps, a.list_it, a.list.cend(), no_yield);
+            state.expansions.driven = false;
+            if(frames.size() != depth+1)
+              return false;
+            if(!scanned)
+              break;
+          }
+          if(!a.ps.dirty)
+            break;
+          pull_out_hash(a.list);
+          begin_pass();
+        }
+        copy_state.replaced = std::move(a.ps.replaced);
+        if(a.cache){
+          expanded_argument e{a.list, {}};
+          std::size_t i = 0;
+          for(auto itt = a.list.cbegin(); itt != a.list.cend(); ++itt, ++i)
+            if(auto r = copy_state.replaced.find(itt); r != copy_state.replaced.end())
+              e.replaced.emplace_back(i, r->second);
+          a.cache->emplace(std::move(e));
+        }
+        auto replaced = state.pool.replace(copy_state, it_, std::next(it_), std::move(a.list));
+        it_ = replaced.end();
+        current.reset();
+        return true;
+      }
+      // returns false when an argument has to be expanded first
+      bool substitute(){
+        while(it_ != copy.end()){
+          if(it_->type() == token_type::punctuator_hash){
+            static constexpr auto search = [](const auto& it, auto sentinel){
+              if(auto found = search_(it, std::move(sentinel), [](auto&& it){++it;}))
+                return *found;
+              throw std::runtime_error(std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: operator # must receive argument");
+            };
+            auto next = search(it_, copy.end());
+            const auto next_i = std::distance(it_, next);
+            const auto next_ai = f->second.arg_index[index+next_i];
+            if(next_ai == 0)
+              throw std::runtime_error(std::string{it_->filename()} + ':' + std::to_string(it_->line()) + ':' + std::to_string(it_->column()) + ": error: # receive invalid(not argument) parameter");
+            auto replaced = (copy|replacer(it_, std::next(next), token_t{{'"' + 
+                    (next_ai < 0 ? stringizer(args[-next_ai-1].begin(), args.back().end())
+                                 : stringizer(args[ next_ai-1])
+                    ) + '"', token_type::string_literal}, it_->annotation()}));
+            it_ = replaced.end();
+            ++state.stats.stringizations;
+            index += next_i+1;
+            trace(it_, index);
+            continue;
+          }
+          if(it_->type() == token_type::punctuator_hashhash){
+            static constexpr auto search = [](const auto& it, auto sentinel){
+              if(auto found = search_(it, std::move(sentinel), [](auto&& it){++it;}))
+                return *found;
+              throw std::runtime_error(std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: operator ## can't receive parameter(search_parameter reach edge)");
+            };
+            auto next = search(it_, copy.end());
+            const auto next_next = std::next(next);
+            const auto next_i = index + std::distance(it_, next);
+            const auto next_ai = f->second.arg_index[next_i];
+            if(next_ai < 0)
+              copy_insert(next, args[-next_ai-1].begin(), args.back().end());
+            else if(next_ai > 0)
+              copy_insert(next, args[ next_ai-1].begin(), args[next_ai-1].end());
+            apply_cat(it_, copy_state);
+            ++state.stats.pastes;
+            it_ = next_next;
+            index = next_i+1;
+            trace(it_, index);
+            continue;
+          }
+          const auto ai = f->second.arg_index[index];
+          static constexpr auto search = [](auto it, auto sentinel){
+            return search_(std::move(it), sentinel, [](auto&& it){++it;}).value_or(sentinel);
+          };
+          const auto next = search(it_, copy.end());
+          if(ai == 0){
+            ++it_;
+            ++index;
+            continue;
+          }
+          else if(next != copy.end() && next->type() == token_type::punctuator_hashhash)
+            if(ai < 0)
+              copy_insert(it_, args[-ai-1].begin(), args.back().end());
+            else
+              copy_insert(it_, args[ ai-1].begin(), args[ai-1].end());
+          else if(!substitute_argument(ai)){
+            ++index;
+            return false;
+          }
+          ++index;
+        }
+        return true;
+      }
+      void finish(){
+        copy.pop_front();
+        profiling.produced(copy.size());
+        ++state.stats.function_expansions;
+        state.stats.hide_set_updates += copy.size();
+        state.stats.produced(copy.size());
+        parent.replaced = std::move(copy_state.replaced);
+        for(auto i = copy.begin(), e = copy.end(); i != e; ++i){
+          if(parent.replaced[i].empty())
+            parent.replaced[i] = recur;
+          else
+            if(std::any_of(parent.replaced[i].begin(), parent.replaced[i].end(), [&](auto&& t){return t == i->get();})){
+              parent.replaced[i].emplace_back(i->get());
+            }
+          parent.replaced[i].emplace_back(it->get());
+        }
+        if constexpr(!Step && !InArithmeticEvaluation)
+          if(state.memo.volatile_expansions == volatile_expansions)
+            state.memo.store(std::move(memo_key), it, arg_it, copy, parent.replaced);
+        replace_invocation(state, parent, it, arg_it, std::move(copy));
+      }
+    };
+    template<bool InArithmeticEvaluation = false, bool Step = false, typename Self, typename Passed, typename Iterator, typename End, typename Yield>
+    auto operator()(Self&& self, Passed&& passed, const phase4_t& state, pp_state& tmp_state, Iterator&& it, const End& end, Yield&& yield)const{
+      const bool driven = std::exchange(state.expansions.driven, false);
+      if(it == end)
+        return false;
+      if(!is_identifier(it->type()))
+        return passed(*it++);
+      if constexpr(InArithmeticEvaluation){
+        if(it->type() == token_type::identifier_defined)
+          return save_defined_argument(std::forward<Passed>(passed), std::forward<Iterator>(it), end);
+        if(it->type() == token_type::identifier_has_include)
+          return save_has_include_argument(std::forward<Passed>(passed), std::forward<Iterator>(it), end);
+      }
+      bool is_pragma_op = false;
+      {
+        const auto make_token_and_pass = [&](std::string&& str, token_type tt = token_type::string_literal){
+          std::list<token_t> list{phase3_t::value_type{{std::move(str), tt}, it->annotation()}};
+          if constexpr(Step)
+            yield(state, tmp_state, it, {output_range<std::list<token_t>::const_iterator>{list.begin(), list.end()}, {std::next(it), end}});
+          if(state.object_cache.recording)
+            throw object_expansion_cache::not_closed{};
+          ++state.memo.volatile_expansions;
+          it = (tmp_state.list|replacer(it, std::next(it), std::move(list))).begin();
+          tmp_state.dirty = true;
+          return true;
+        };
+        switch(it->type()){
+        case token_type::identifier_time_:
+          return make_token_and_pass('"'+time()+'"');
+        case token_type::identifier_date_:
+          return make_token_and_pass('"'+date()+'"');
+        case token_type::identifier_file_:
+          return make_token_and_pass('"'+escape(it->filename())+'"');
+        case token_type::identifier_line_:
+          return make_token_and_pass(std::to_string(it->line()), token_type::pp_number);
+        case token_type::identifier_pragma_op:
+          is_pragma_op = true;
+          [[fallthrough]];
+        default:
+          break;
+        }
+      }
+      state.object_cache.record(it->get());
+      {
+        auto object_it = state.objects->find(it->get());
+        if(object_it != state.objects->end())
+          return object_macro_replace<Step>(object_it, std::forward<Passed>(passed), state, tmp_state, std::forward<Iterator>(it), end, std::forward<Yield>(yield));
+      }
+      constexpr auto white_spaces = veiler::pegasus::filter([](auto&& it, [[maybe_unused]] auto&&... unused){return is_white_spaces(veiler::pegasus::member_access<token_type>(*it++));})[veiler::pegasus::semantic_actions::omit];
+      struct arg_parser_data{
+        using type = std::decay_t<Iterator>;
+        std::optional<type> first;
+        std::optional<type> last;
+        unsigned long nest_count;
+      };
+      auto not_arg = _(token_type::punctuator_comma) | _(token_type::punctuator_right_parenthesis);
+      auto arg_parser = *white_spaces
+                     >> ( +veiler::pegasus::freeze
+                          (  (  _(token_type::punctuator_left_parenthesis) >> *white_spaces
+                             >> *( _(token_type::punctuator_comma) >> *white_spaces
+                                 | veiler::pegasus::self<veiler::pegasus::unit>[veiler::pegasus::semantic_actions::omit] >> *white_spaces
+                                 )
+                             >> _(token_type::punctuator_right_parenthesis) >> *white_spaces
+                             )
+                             |
+                             ( veiler::pegasus::read - not_arg - _(token_type::punctuator_left_parenthesis))[veiler::pegasus::semantic_actions::omit]
+                          )
+                          |
+                          &not_arg//empty token
+                        )
+                        ;
+      auto arg_parser_registrar = [](auto&& first, auto&& loc){
+        auto ret = output_range<std::list<token_t>::const_iterator>{first, loc.end()};
+        return ret;
+      };
+      auto args_parser =  _(token_type::punctuator_left_parenthesis)
+                       >> ( (*white_spaces)[([](auto&&, auto&& loc){return loc.end();})]
+                         >> arg_parser[veiler::pegasus::semantic_actions::omit]
+                          )[arg_parser_registrar] % _(token_type::punctuator_comma)
+                       >> _(token_type::punctuator_right_parenthesis);
+      auto f = state.functions->find(it->get());
+      if(f == state.functions->end() && !is_pragma_op)
+        return passed(*it++);
+      std::vector<output_range<std::list<token_t>::const_iterator>> args;
+      auto arg_it = search_(it, end, [](auto&& t){++t;}).value_or(end);
+      if(arg_it == end)
+        return passed(*it++);
+      if(!(&_(token_type::punctuator_left_parenthesis))(arg_it, end))
+        return passed(*it++);
+      if(auto parsed_result = args_parser(arg_it, end))
+        args = *parsed_result;
+      else{
+        for(auto itt = it, end = std::next(arg_it); itt != end; ++itt){
+          if(tmp_state.replaced.find(itt) != tmp_state.replaced.end())
+            return passed(*it++);
+        }
+        throw std::runtime_error(std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: ')' does not exist");
+      }
+      if(is_pragma_op){
+        if(args.size() != 1)
+          return false;
+        {
+          auto it = args[0].begin();
+          ++it;
+          if(it != args[0].end())
+            return false;
+        }
+        if(args[0].begin()->type() != token_type::string_literal)
+          return false;
+        if(state.object_cache.recording)
+          throw object_expansion_cache::not_closed{};
+        ++state.memo.volatile_expansions;
+        state.pragmas.emplace_back(string_literal::destringize(*args[0].begin())->str);
+        it = arg_it;
+        return true;
+      }
+      if(f->second.arg_num > 0 && f->second.arg_num != static_cast<int>(args.size()))
+        return false;
+      //if argument list is (...) /*f->second.arg_num == -1*/, we can pass no arguments
+      //but (a, b, ...), we need 3 or more arguments(can't pass 2 arguments)
+      //GCC and clang can pass 2 args
+      static constexpr auto allow_pass_no_arg_to_variadic_param = false;
+      if(f->second.arg_num < -1 && -f->second.arg_num - (allow_pass_no_arg_to_variadic_param ? 1 : 0) > static_cast<int>(args.size()))
+        return false;
+      if(allow_pass_no_arg_to_variadic_param && f->second.arg_num < -1 && -f->second.arg_num - 1 == static_cast<int>(args.size()))
+        args.emplace_back(output_range<std::list<token_t>::const_iterator>{args.back().end(), args.back().end()});
+      if(f->second.arg_num == -1 && static_cast<int>(args.size()) == 0)
+        args.emplace_back(output_range<std::list<token_t>::const_iterator>{it, it});
+      bool first = true;
+      std::vector<std::string> recur;
+      for(auto it_ = it; it_ != arg_it && (first || !recur.empty()); ++it_){
+        auto rit = tmp_state.replaced.find(it_);
+        if(rit != tmp_state.replaced.end()){
+          if(first)
+            recur = rit->second, first = false;
+          else
+            recur = vector_product(std::move(recur), rit->second);
+        }
+        else
+          recur.clear(), first = false;
+      }
+      for(auto&& x : recur){
+        if(x == it->get()){
+          return passed(*it++);
+        }
+      }
+      {
+        auto rit = tmp_state.replaced.find(it);
+        if(rit != tmp_state.replaced.end())
+          for(auto&& x : rit->second)
+            if(x == it->get()){
+              return passed(*it++);
+            }
+      }
+      std::string memo_key;
+      if constexpr(!Step && !InArithmeticEvaluation){
+        memo_key = expansion_memo::key(it, arg_it, tmp_state.replaced);
+        if(const auto memoized = state.object_cache.recording ? nullptr : state.memo.find(memo_key)){
+          expansion_profiler::scope profiling{state.profiler.get(), it->get()};
+          auto copy = expansion_memo::load(*memoized, it, arg_it, tmp_state.replaced, state.pool);
+          profiling.produced(copy.size());
+          ++state.stats.function_expansions;
+          ++state.stats.memoized_expansions;
+          state.stats.hide_set_updates += copy.size();
+          state.stats.produced(copy.size());
+          return replace_invocation(state, tmp_state, it, arg_it, std::move(copy));
+        }
+      }
+      auto& frames = state.expansions.frames;
+      const auto base = frames.size();
+      frames.emplace_back(std::make_unique<invocation<InArithmeticEvaluation, Step, std::decay_t<Iterator>, std::decay_t<Yield>>>(*this, state, tmp_state, it, arg_it, end, yield, f, std::move(args), std::move(recur), std::move(memo_key), base));
+      if(driven)
+        return true;
+      struct unwind{
+        std::vector<std::unique_ptr<expansion_frame>>& frames;
+        std::size_t base;
+        ~unwind(){
+          while(frames.size() > base)
+            frames.pop_back();
+        }
+      }_{frames, base};
+      while(frames.size() > base)
+        if(!frames.back()->resume())
+          frames.pop_back();
+      return true;
+    }
+  }static constexpr eval_macro = {};
+  template<typename T>
+  std::optional<std::filesystem::path> find_include_path(T&& tmp, const std::filesystem::path current_path)const{
+    std::filesystem::path include_file;
+    bool is_angle = false;
+    {
+      if(tmp.begin()->type() == token_type::header_name){
+        auto&& str = tmp.begin()->get();
+        include_file = str.substr(1, str.size()-2);
+        is_angle = str[0] == '<';
+      }
+      else{
+        std::string str;
+        for(auto&& x : tmp)
+          if(str.empty() && x.type() == token_type::white_space)
+            continue;
+          else
+            str += x.get();
+        const auto parser =
+          ( _('<') >> +(veiler::pegasus::read - _('>'))[veiler::pegasus::semantic_actions::value] >> _('>') )[veiler::pegasus::semantic_actions::change_container<std::string>][([&](auto&& v, [[maybe_unused]] auto&&... unused){include_file = std::move(v); is_angle = true; return veiler::pegasus::unit{};})]
+          | ( _('"') >> +(veiler::pegasus::read - _('"'))[veiler::pegasus::semantic_actions::value] >> _('"') )[veiler::pegasus::semantic_actions::change_container<std::string>][([&](auto&& v, [[maybe_unused]] auto&&... unused){include_file = std::move(v); is_angle = false;return veiler::pegasus::unit{};})];
+        auto result = parser(str.begin(), str.end());
+        if(!result)
+          return std::nullopt;
+      }
+    }
+    return find_include_path(include_file, is_angle, current_path);
+  }
+  std::optional<std::filesystem::path> find_include_path(const std::filesystem::path& include_file, bool is_angle, const std::filesystem::path& current_path)const{
+    auto f = [&](const std::filesystem::path& path){
+      if(!std::filesystem::exists(path) || std::filesystem::is_directory(path))
+        return false;
+      return true;
+    };
+    if(!is_angle && std::filesystem::exists(current_path/include_file))
+      return std::filesystem::canonical(current_path/include_file);
+    for(auto&& x : include_dir)
+      if(f(x/include_file))
+        return std::filesystem::canonical(x/include_file);
+    for(auto&& x : system_include_dir)
+      if(f(x/include_file))
+        return std::filesystem::canonical(x/include_file);
+    return std::nullopt;
+  }
+  struct arithmetic_expression;
+  std::optional<std::intmax_t> evaluate_condition(const std::list<token_t>& tokens, const std::filesystem::path& current_path)const;
+  struct preprocessing_file;
+  struct override_annotate{
+    std::string filename;
+    std::size_t base_line;
+    std::size_t org_line;
+  };
+ public:
+  template<bool InArithmeticEvaluation = false>
+  std::list<token_t> eval(std::list<token_t>& ls, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& r, override_annotate& override_annotation, const std::filesystem::path& current_path, bool step_flag, std::ostream& os);
+  // evaluates the _Pragma operators collected in `pragmas`
+  void eval_pragmas(std::ostream& os);
+  bool condition_holds(std::list<token_t>& ls, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& directive, override_annotate& override_annotation, const std::filesystem::path& current_path, std::ostream& os);
+  std::optional<std::filesystem::path> resolve_include(pp_state& state, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& header, const std::filesystem::path& current_path);
+  std::list<token_t> operator()(std::list<token_t>& ls, const std::filesystem::path& current_path, std::ostream& os);
+  // processes `is` line by line and passes the output of each completed line to `sink`
+  void stream(std::istream& is, std::string_view filename, const std::filesystem::path& current_path, const std::function<void(std::list<token_t>&&)>& sink, std::ostream& os);
+  struct stream_lines;
+  struct file_lines;
+  template<typename Lines>
+  void process_lines(Lines& lines, std::string_view filename, const std::filesystem::path& current_path, const std::function<void(std::list<token_t>&&)>& sink, std::ostream& os);
+  // resolves, reads and lexes the headers named by the #include lines of loaded files on background threads
+  class include_prefetcher{
+    struct entry{
+      bool ready = false;
+      bool minimized = false;
+      std::shared_ptr<const token_table> tokens;
+    };
+    struct job{
+      std::string header;
+      bool is_angle;
+      std::filesystem::path current_path;
+      bool minimize;
+      // the run which queued it, jobs of earlier runs are dropped
+      std::size_t generation;
+    };
+    // threads shared by a state and its snapshots, joined when the last of them is destroyed
+    class worker_pool{
+      std::mutex mutex;
+      std::condition_variable jobs_available;
+      std::condition_variable idle;
+      std::deque<std::pair<include_prefetcher*, job>> jobs;
+      std::vector<std::thread> threads;
+      bool stopping = false;
+      void work();
+     public:
+      ~worker_pool();
+      void push(include_prefetcher& owner, std::vector<job>&& found);
+      // drops the queued jobs of `owner` and waits for those the threads are running
+      void cancel(include_prefetcher& owner);
+    };
+    const phase4_t& state;
+    std::shared_ptr<worker_pool> workers;
+    std::mutex mutex;
+    std::condition_variable loaded;
+    // canonical paths which are loaded or being loaded
+    std::unordered_set<std::string> seen;
+    std::unordered_map<std::string, entry> results;
+    std::set<std::string, std::less<>> filenames;
+    std::size_t generation = 0;
+    // jobs of this prefetcher the threads are running, guarded by the mutex of `workers`
+    std::size_t running = 0;
+    void work(job&& j);
+    void scan(std::string_view source, const std::filesystem::path& current_path, bool minimize, std::size_t generation);
+   public:
+    // snapshots share the workers of their base
+    explicit include_prefetcher(const phase4_t& state);
+    ~include_prefetcher();
+    // waits for the jobs which read the include directories of `state` and clears
+    void stop();
+    // drops the files which have not been taken, those of headers in skipped groups are never taken
+    // jobs still queued or running for the last run are dropped when the workers get to them
+    void clear();
+    // snapshots skip the headers their base has cached
+    void scan(std::string_view source, const std::filesystem::path& current_path, bool minimize);
+    // the tokens of `canonical` if they have been prefetched, waits while they are being lexed
+    std::shared_ptr<const token_table> take(const std::string& canonical, bool minimized);
+  };
+  // declared last so that its jobs finish before the rest of the state is destroyed
+  include_prefetcher prefetcher{*this};
+};
+
+#undef INLINE_RULE
+#undef AUTO_RULE
+#undef RULE
+
+// concatenates adjacent string literals, the other tokens are passed to the sink as they come
+class phase6_t{
+  using token_t = phase3_t::value_type;
+  struct parts{
+    std::string_view prefix;
+    bool raw;
+    std::string_view body;
+    std::string_view suffix;
+  };
+  static parts split(std::string_view spelling){
+    const auto quote = spelling.find('"');
+    const bool raw = quote > 0 && spelling[quote-1] == 'R';
+    const auto prefix = spelling.substr(0, raw ? quote-1 : quote);
+    if(!raw){
+      const auto close = spelling.rfind('"');
+      return {prefix, false, spelling.substr(quote+1, close-quote-1), spelling.substr(close+1)};
+    }
+    const auto open = spelling.find('(', quote);
+    const auto delimiter = spelling.substr(quote+1, open-quote-1);
+    const auto close = spelling.rfind('"');
+    return {prefix, true, spelling.substr(open+1, close-delimiter.size()-1-open-1), spelling.substr(close+1)};
+  }
+  //whether `c` would continue a numeric escape sequence at the end of `body`
+  static bool continues_escape(std::string_view body, char c){
+    const auto escaping = [&](std::size_t backslash){
+      std::size_t n = 0;
+      while(n <= backslash && body[backslash-n] == '\\')
+        ++n;
+      return n % 2 == 1;
+    };
+    const auto is_octal = [](char c){return '0' <= c && c <= '7';};
+    std::size_t hex = body.size();
+    while(hex > 0 && std::isxdigit(static_cast<unsigned char>(body[hex-1])))
+      --hex;
+    if(std::isxdigit(static_cast<unsigned char>(c)) && hex >= 2 && body[hex-1] == 'x' && escaping(hex-2))
+      return true;
+    if(!is_octal(c))
+      return false;
+    for(std::size_t digits = 1; digits < 3 && digits < body.size(); ++digits){
+      if(!is_octal(body[body.size()-digits]))
+        return false;
+      if(body[body.size()-digits-1] == '\\')
+        return escaping(body.size()-digits-1);
+    }
+    return false;
+  }
+  std::optional<token_t> literal;
+  std::vector<token_t> separators;
+  std::size_t count = 0;
+  std::string prefix;
+  std::string body;
+  std::string suffix;
+  void append(const token_t& token){
+    const auto p = split(token.get());
+    if(prefix.empty())
+      prefix = p.prefix;
+    else if(!p.prefix.empty() && prefix != p.prefix)
+      throw std::runtime_error("concat string literals failed (unmatch prefixes)");
+    if(suffix.empty())
+      suffix = p.suffix;
+    else if(!p.suffix.empty() && suffix != p.suffix)
+      throw std::runtime_error("concat string literals failed (unmatch user-defined literals)");
+    const auto escaped = p.raw ? escape(p.body) : std::string{};
+    std::string_view str = p.raw ? std::string_view{escaped} : p.body;
+    if(!str.empty() && continues_escape(body, str.front())){
+      const unsigned char c = str.front();
+      body += '\\';
+      body += static_cast<char>('0' + (c >> 6));
+      body += static_cast<char>('0' + (c >> 3 & 7));
+      body += static_cast<char>('0' + (c & 7));
+      str.remove_prefix(1);
+    }
+    body += str;
+  }
+  template<typename Sink>
+  void flush(Sink& sink){
+    if(count == 1)
+      sink(std::move(*literal));
+    else if(count > 1){
+      std::string spelling;
+      spelling.reserve(prefix.size() + body.size() + suffix.size() + 2);
+      spelling.append(prefix).append(1, '"').append(body).append(1, '"').append(suffix);
+      sink(token_t{{std::move(spelling), token_type::string_literal}, literal->annotation()});
+    }
+    for(auto&& x : separators)
+      sink(std::move(x));
+    separators.clear();
+    literal.reset();
+    count = 0;
+  }
+ public:
+  template<typename Sink>
+  void operator()(token_t token, Sink&& sink){
+    if(token.type() == token_type::string_literal){
+      if(count++ == 0){
+        literal = std::move(token);
+        return;
+      }
+      if(count == 2){
+        prefix.clear();
+        body.clear();
+        suffix.clear();
+        append(*literal);
+      }
+      append(token);
+      separators.clear();
+    }
+    else if(count != 0 && is_white_spaces(token.type()))
+      separators.emplace_back(std::move(token));
+    else{
+      flush(sink);
+      sink(std::move(token));
+    }
+  }
+  template<typename Sink>
+  void finish(Sink&& sink){
+    flush(sink);
+  }
+};
+
+class split_range{
+  std::string_view target;
+  std::string delimiters;
+ public:
+  class iterator{
+    std::string_view delimiters;
+    std::string_view::const_iterator prev, it, end;
+   public:
+    iterator() = default;
+    iterator(std::string_view delim, const std::string_view::const_iterator& begin, const std::string_view::const_iterator& end):delimiters{delim}, prev{begin}, it{begin}, end{end}{++*this;}
+    using value_type = std::string_view;
+    iterator& operator++(){
+      static constexpr auto f = [](auto& prev, auto it, auto end){
+        if(it == end){
+          prev = it;
+          return false;
+        }
+        return true;
+      };
+      while(f(prev, it, end))
+        if(delimiters.find(*it) == std::string_view::npos){
+          prev = it;
+          break;
+        }
+        else
+          ++it;
+      while(it != end)
+        if(delimiters.find(*it) != std::string_view::npos)
+          break;
+        else
+          ++it;
+      return *this;
+    }
+    value_type operator*()const{return value_type{&*prev, static_cast<std::string_view::size_type>(it-prev)};}
+    constexpr bool operator!=(const iterator& rhs){
+      auto lt = prev;
+      while(lt != end && delimiters.find(*lt) != std::string_view::npos)
+        ++lt;
+      auto rt = rhs.prev;
+      while(rt != end && delimiters.find(*rt) != std::string_view::npos)
+        ++rt;
+      return lt != rt;
+    }
+  };
+  split_range(std::string_view target, std::string delimiters):target{target}, delimiters{std::move(delimiters)}{}
+  iterator begin()const{return iterator{delimiters, target.begin(), target.end()};}
+  iterator end()const{return iterator{{}, target.end(), target.end()};}
+};
+
+}
+
+#endif
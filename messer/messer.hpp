@@ -0,0 +1,93 @@
+#ifndef MESSER_MESSER_HPP_INCLUDED
+#define MESSER_MESSER_HPP_INCLUDED
+
+#include<cstddef>
+#include<filesystem>
+#include<functional>
+#include<iosfwd>
+#include<memory>
+#include<string>
+#include<string_view>
+#include<vector>
+#include<messer/token_type.hpp>
+
+namespace messer{
+
+struct token_view{
+  token_type type;
+  std::string_view spelling;
+  std::string_view filename;
+  std::size_t line;
+  std::size_t column;
+};
+
+// the views are valid only during the call
+using token_sink = std::function<void(const token_view&)>;
+using step_callback = std::function<void(std::string_view)>;
+using diagnostic_handler = std::function<void(std::string_view)>;
+
+token_sink write_to(std::ostream& os);
+
+class preprocessor{
+  struct impl;
+  std::unique_ptr<impl> pimpl;
+ public:
+  preprocessor();
+  preprocessor(preprocessor&&)noexcept;
+  preprocessor& operator=(preprocessor&&)noexcept;
+  ~preprocessor();
+  // a preprocessor sharing the macros, include directories and caches of this one until either defines or undefines a macro
+  // this one must outlive the snapshot and must not be used while the snapshot is in use, except by other snapshots
+  preprocessor snapshot()const;
+  void add_include_dir(const std::filesystem::path& dir);
+  void add_system_include_dir(const std::filesystem::path& dir);
+  const std::vector<std::filesystem::path>& include_dirs()const;
+  const std::vector<std::filesystem::path>& system_include_dirs()const;
+  // system include directories of the host compiler and the predefined macros
+  void add_host_defaults();
+  // `definition` is the text following `#define`, e.g. "CAT(a, b) a ## b"
+  void define(std::string_view definition);
+  void undef(std::string_view name);
+  bool is_defined(std::string_view name)const;
+  std::vector<std::string> macro_names()const;
+  std::vector<std::string> function_macro_names()const;
+  // after each call, releases the least recently included files until their tokens fit in `bytes`
+  // the released files are lexed again when they are included next
+  void set_file_cache_limit(std::size_t bytes);
+  // output of #pragma messer and #pragma step
+  void set_output(std::ostream& os);
+  // messages of failures which do not stop preprocessing, written to std::cerr by default
+  void set_diagnostic_handler(diagnostic_handler handler);
+  // evaluates directives only, the preprocessed text is discarded
+  void load_file(const std::filesystem::path& path);
+  void preprocess_file(const std::filesystem::path& path, const token_sink& sink);
+  // the macros are left as they were when it throws
+  void preprocess(std::string_view source, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path = std::filesystem::current_path());
+  // reads `is` line by line and passes the tokens of each line as soon as it is complete, the included files are lexed one line at a time
+  void preprocess_stream(std::istream& is, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path = std::filesystem::current_path());
+  // evaluates only #include, conditional, #define and #undef directives of `path` and the files it includes
+  void scan_file(const std::filesystem::path& path);
+  // files included by the last preprocess_file, preprocess_stream or scan_file, in order of first inclusion
+  std::vector<std::filesystem::path> dependencies()const;
+  // calls `callback` with each replacement step of `text`, as `#pragma step` does
+  void step(std::string_view text, const step_callback& callback);
+  // counters of the last preprocess_file, preprocess_stream or scan_file and the preprocess calls since
+  void write_stats_text(std::ostream& os)const;
+  void write_stats_json(std::ostream& os)const;
+  // estimated bytes held per part of the state, the hide sets and temporaries at their largest since the last preprocess_file, preprocess_stream or scan_file
+  void write_memory_text(std::ostream& os)const;
+  void write_memory_json(std::ostream& os)const;
+  // passes the tokens of `source` as the preprocessor lexes it, without preprocessing it
+  static void tokenize(std::string_view source, std::string_view filename, const token_sink& sink);
+  void enable_profiling();
+  bool profiling()const;
+  void write_profile_text(std::ostream& os)const;
+  void write_profile_json(std::ostream& os)const;
+};
+
+// serves preprocess, expand and step requests on the unix domain socket `path` until the process exits, each on a snapshot of `base`
+void serve(const preprocessor& base, const std::filesystem::path& path, unsigned threads);
+
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MESSER_TOKEN_TYPE_HPP_INCLUDED
+#define MESSER_TOKEN_TYPE_HPP_INCLUDED
+
+#include<ostream>
+#include<type_traits>
+#include<boost/preprocessor/seq/enum.hpp>
+#include<boost/preprocessor/seq/for_each.hpp>
+#include<boost/preprocessor/stringize.hpp>
+
+namespace messer{
+
+#define MESSER_DECL_TOKEN_TYPE(sequence) \
+enum class token_type{\
+  BOOST_PP_SEQ_ENUM(sequence)\
+  , END\
+};\
+inline std::ostream& operator<<(std::ostream& os, token_type t){\
+  switch(t){\
+    BOOST_PP_SEQ_FOR_EACH(MESSER_DECL_TOKEN_TYPE_I, _, sequence)\
+    default:os<<"unknown("<<static_cast<std::underlying_type_t<token_type>>(t)<<')';\
+  }\
+  return os;\
+}
+#define MESSER_DECL_TOKEN_TYPE_I(r, _, name) case token_type::name: os << BOOST_PP_STRINGIZE(name);break;
+
+#define PUNCTUATORS \
+  (punctuator)(punctuator_hash)(punctuator_hashhash)(punctuator_left_parenthesis)(punctuator_comma)(punctuator_ellipsis)(punctuator_right_parenthesis)(punctuator_left_shift)(punctuator_right_shift)(punctuator_less_equal)(punctuator_greater_equal)(punctuator_less)(punctuator_greater)(punctuator_equalequal)(punctuator_not_equal)(punctuator_logical_or)(punctuator_logical_and)(punctuator_logical_not)(punctuator_ampersand)(punctuator_asterisk)(punctuator_plus)(punctuator_minus)(punctuator_division)(punctuator_modulo)(punctuator_bitwise_or)(punctuator_bitwise_xor)(punctuator_bitwise_not)(punctuator_question)(punctuator_colon)
+#define IDENTIFIERS \
+  (identifier)(identifier_include)(identifier_define)(identifier_undef)(identifier_line)(identifier_error)(identifier_pragma)(identifier_if)(identifier_ifdef)(identifier_ifndef)(identifier_elif)(identifier_else)(identifier_endif)(identifier_defined)(identifier_time_)(identifier_date_)(identifier_file_)(identifier_line_)(identifier_pragma_op)(identifier_has_include)(identifier_true)(identifier_false)
+MESSER_DECL_TOKEN_TYPE(
+  (empty)
+  (white_space)
+  (eol)
+  (header_name)
+  PUNCTUATORS
+  (character_literal)
+  (string_literal)
+  (pp_number)
+  IDENTIFIERS
+  (unclassified_character)
+)
+#undef MESSER_DECL_TOKEN_TYPE_I
+#undef MESSER_DECL_TOKEN_TYPE
+
+inline bool is_white_spaces(const token_type& t)noexcept{switch(t){case token_type::white_space: case token_type::eol: return true;default:return false;}}
+#define MESSER_DECL_TOKEN_TYPE(r, _, name) case token_type::name:
+inline bool is_punctuator(const token_type& t)noexcept{switch(t){BOOST_PP_SEQ_FOR_EACH(MESSER_DECL_TOKEN_TYPE, _, PUNCTUATORS)return true; default: return false;}}
+inline bool is_identifier(const token_type& t)noexcept{switch(t){BOOST_PP_SEQ_FOR_EACH(MESSER_DECL_TOKEN_TYPE, _, IDENTIFIERS)return true; default: return false;}}
+#undef MESSER_DECL_TOKEN_TYPE
+#undef IDENTIFIERS
+#undef PUNCTUATORS
+
+}
+
+#endif
@@ -0,0 +1,223 @@
+#include<messer/core.hpp>
+#include<boost/range/adaptor/reversed.hpp>
+
+#define RULE VEILER_PEGASUS_RULE
+#define AUTO_RULE VEILER_PEGASUS_AUTO_RULE
+#define INLINE_RULE VEILER_PEGASUS_INLINE_RULE
+
+namespace messer{
+
+struct phase4_t::arithmetic_expression : veiler::pegasus::parsers<phase4_t::arithmetic_expression>{
+  static auto entrypoint(){
+    return instance().conditional_expression.with_skipper(*instance()._);
+  }
+ private:
+  static constexpr auto omit = veiler::pegasus::semantic_actions::omit;
+  template<typename T>
+  static constexpr auto lit(T&& t){return veiler::pegasus::lit(std::forward<T>(t));}
+#define SIMPLE_RULE(name, operator_name, operator, next_rule) \
+  RULE(name, std::intmax_t, veiler::pegasus::transient(\
+       ( rules.next_rule\
+      >> *( lit(token_type::operator_name)[omit]\
+         >> rules.next_rule\
+          )\
+       )[([](auto&& v, [[maybe_unused]] auto&&... unused){\
+          return std::accumulate(v.begin()+1, v.end(), *v.begin(), [](auto&& lhs, auto&& rhs){return lhs operator rhs;});\
+        })]\
+      ))
+#define TWO_OPERATOR_RULE(name, operator_name1, operator1, operator_name2, operator2, next_rule) \
+  RULE(name, std::intmax_t, veiler::pegasus::transient(\
+       ( rules.next_rule\
+      >> *( ( lit(token_type::operator_name1)[omit][([]([[maybe_unused]]auto&&... unused){return true;})]\
+            | lit(token_type::operator_name2)[omit][([]([[maybe_unused]]auto&&... unused){return false;})]\
+            )\
+         >> rules.next_rule\
+          )\
+       )[([](auto&& v, [[maybe_unused]] auto&&... unused){\
+          auto&& [first, exps] = v;\
+          for(auto&& [op, val] : exps)\
+            if(op)\
+              first = first operator1 val;\
+            else\
+              first = first operator2 val;\
+          return first;\
+        })]\
+      ))
+  RULE(conditional_expression, std::intmax_t, veiler::pegasus::transient(
+       ( rules.logical_or
+      >> *( lit(token_type::punctuator_question)[omit]
+         >> rules.logical_or
+         >> lit(token_type::punctuator_colon)[omit]
+         >> rules.logical_or
+          )
+       )[([](auto&& v, [[maybe_unused]] auto&&... unused){
+          auto&& [first, tf] = v;
+          for(auto&& x : tf)
+            if(first == 0)
+              first = x[1];
+            else
+              return x[0];
+          return first;
+        })]
+      ))
+  SIMPLE_RULE(logical_or , punctuator_logical_or , ||, logical_and)
+  SIMPLE_RULE(logical_and, punctuator_logical_and, &&, bitwise_or )
+  SIMPLE_RULE(bitwise_or , punctuator_bitwise_or ,  |, bitwise_xor)
+  SIMPLE_RULE(bitwise_xor, punctuator_bitwise_xor,  ^, bitwise_and)
+  SIMPLE_RULE(bitwise_and, punctuator_ampersand  ,  &, equal)
+  TWO_OPERATOR_RULE(equal, punctuator_equalequal, ==,
+                           punctuator_not_equal,  !=, compare)
+  AUTO_RULE(compare, veiler::pegasus::transient(
+       ( rules.shift
+      >> *( ( lit(token_type::punctuator_less)
+            | lit(token_type::punctuator_less_equal)
+            | lit(token_type::punctuator_greater)
+            | lit(token_type::punctuator_greater_equal)
+            )[([](auto&& v, [[maybe_unused]]auto&&... unused){return v->type();})]
+         >> rules.shift
+          )
+       )[([](auto&& v, [[maybe_unused]] auto&&... unused){
+          auto&& [first, cmps] = v;
+          for(auto&& [op, val] : cmps)
+            switch(op){
+            case token_type::punctuator_less:          first = first <  val; break;
+            case token_type::punctuator_less_equal:    first = first <= val; break;
+            case token_type::punctuator_greater:       first = first >  val; break;
+            case token_type::punctuator_greater_equal: first = first >= val; break;
+            default:                                                         break;
+            }
+          return first;
+        })]
+      ))
+  TWO_OPERATOR_RULE(shift,  punctuator_left_shift,  <<,
+                            punctuator_right_shift, >>, addsub)
+  TWO_OPERATOR_RULE(addsub, punctuator_plus,         +,
+                            punctuator_minus,        -, muldiv)
+  AUTO_RULE(muldiv, veiler::pegasus::transient(
+       ( rules.unary
+      >> *( ( lit(token_type::punctuator_asterisk)
+            | lit(token_type::punctuator_division)
+            | lit(token_type::punctuator_modulo)
+            )[([](auto&& v, [[maybe_unused]]auto&&... unused){return v->type();})]
+         >> rules.unary
+          )
+       )[([](auto&& v, auto&& loc, [[maybe_unused]] auto&&... unused)->veiler::expected<std::intmax_t, veiler::pegasus::parse_error<std::decay_t<decltype(loc.begin())>>>{
+          auto&& [first, muls] = v;
+          for(auto&& [op, val] : muls)
+            switch(op){
+            case token_type::punctuator_asterisk:                                                                                                             first = first * val; break;
+            case token_type::punctuator_division: if(val == 0)return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"div zero"}); first = first / val; break;
+            case token_type::punctuator_modulo:   if(val == 0)return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"mod zero"}); first = first % val; break;
+            default:                                                   break;
+            }
+          return first;
+        })]
+      ))
+  AUTO_RULE(unary, veiler::pegasus::transient(
+       ( *( ( lit(token_type::punctuator_plus)
+            | lit(token_type::punctuator_minus)
+            | lit(token_type::punctuator_logical_not)
+            | lit(token_type::punctuator_bitwise_not)
+            )[([](auto&& v, [[maybe_unused]]auto&&... unused){return v->type();})]
+          )
+      >> rules.primary
+       )[([](auto&& v, [[maybe_unused]] auto&&... unused){
+          auto&& [ops, val] = v;
+          for(auto&& op : ops | boost::adaptors::reversed)
+            switch(op){
+            case token_type::punctuator_plus:                    break;
+            case token_type::punctuator_minus:       val = -val; break;
+            case token_type::punctuator_logical_not: val = !val; break;
+            case token_type::punctuator_bitwise_not: val = ~val; break;
+            default:                                             break;
+            }
+          return val;
+        })]
+      ))
+  AUTO_RULE(primary, veiler::pegasus::transient(
+      ( lit(token_type::pp_number)[([](auto&& v, [[maybe_unused]] auto&&... unused)->veiler::expected<std::intmax_t, veiler::pegasus::parse_error<std::decay_t<decltype(v)>>>{
+          std::size_t index;
+          auto vstr = v->get();
+          vstr.erase(std::remove_if(vstr.begin(), vstr.end(), [](char c){return c == '\'';}), vstr.end());
+          auto value = std::stoull(vstr, &index, 0);
+          {
+            bool is_unsigned = false;
+            bool is_long = false;
+            bool is_long_long = false;
+            for(;index < vstr.size(); ++index){
+              switch(vstr[index]){
+              case 'u':case'U':
+                if(std::exchange(is_unsigned, true))
+                  return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"duplicate u suffix"});
+                break;
+              case 'l':case 'L':
+                if(index+1 < vstr.size() && vstr[index] == vstr[index+1]){
+                  ++index;
+                  if(is_long)
+                    return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"exists l suffix and ll suffix together"});
+                  if(std::exchange(is_long_long, true))
+                    return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"duplicate ll suffix"});
+                }
+                else{
+                  if(is_long_long)
+                    return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"exists l suffix and ll suffix together"});
+                 if(std::exchange(is_long, true))
+                    return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"duplicate l suffix"});
+                }
+                break;
+              default:
+                return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{"invalid suffix"});
+              }
+            }
+          }
+          return static_cast<std::intmax_t>(value);
+        })]
+      | lit(token_type::character_literal)[([](auto&& v, [[maybe_unused]] auto&&... unused)->veiler::expected<std::intmax_t, veiler::pegasus::parse_error<std::decay_t<decltype(v)>>>{
+          return static_cast<std::intmax_t>(0);
+        })]
+      | lit(token_type::punctuator_left_parenthesis)[omit]
+     >> rules.conditional_expression
+     >> lit(token_type::punctuator_right_parenthesis)[omit]
+      | lit(token_type::identifier_true)[omit][([]([[maybe_unused]]auto&&... unused){return static_cast<std::intmax_t>(true);})]
+      | lit(token_type::identifier_false)[omit][([]([[maybe_unused]]auto&&... unused){return static_cast<std::intmax_t>(false);})]
+      | ( lit(token_type::identifier_defined)[omit]
+       >> ( ( lit(token_type::punctuator_left_parenthesis)[omit]
+           >> rules.identifier
+           >> lit(token_type::punctuator_right_parenthesis)[omit]
+            )
+            | rules.identifier
+          )
+        )[([](auto&& v, auto&&, auto&& s, [[maybe_unused]] auto&&... unused)->std::intmax_t{
+          return v->type() == token_type::identifier_has_include || s.objects->find(v->get()) != s.objects->end() || s.functions->find(v->get()) != s.functions->end() ? 1 : 0;
+        })]
+      | ( lit(token_type::identifier_has_include)[omit]
+       >> lit(token_type::punctuator_left_parenthesis)[omit]
+       >> ( lit(token_type::header_name)
+          | lit(token_type::string_literal)
+          | veiler::pegasus::lexeme[lit(token_type::punctuator_less) >> *(veiler::pegasus::read - lit(token_type::punctuator_greater)) >> lit(token_type::punctuator_greater)]
+          )[veiler::pegasus::semantic_actions::location]
+       >> lit(token_type::punctuator_right_parenthesis)[omit]
+        )[([](auto&& v, auto&&, auto&& s, auto&& c, [[maybe_unused]] auto&&... unused)->std::intmax_t{
+          return s.find_include_path(v, c) ? 1 : 0;
+        })]
+      | rules.identifier[omit][([]([[maybe_unused]]auto&&... unused){return static_cast<std::intmax_t>(0);})]
+      )
+      ))
+  INLINE_RULE(identifier, veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return is_identifier((v++)->type());}))
+  INLINE_RULE(_, veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return (v++)->type() == token_type::white_space;}))
+#undef TWO_OPERATOR_RULE
+#undef SIMPLE_RULE
+};
+
+std::optional<std::intmax_t> phase4_t::evaluate_condition(const std::list<token_t>& tokens, const std::filesystem::path& current_path)const{
+  auto result = arithmetic_expression::entrypoint()(tokens, *this, current_path);
+  if(!result)
+    return std::nullopt;
+  return *result;
+}
+
+}
+
+#undef INLINE_RULE
+#undef AUTO_RULE
+#undef RULE
@@ -0,0 +1,109 @@
+#include<messer/core.hpp>
+#include<algorithm>
+
+namespace messer{
+
+std::list<phase3_t::value_type> lex(const std::string& source, std::string_view filename, std::size_t line){
+  static constexpr phase1_t phase1;
+  static constexpr phase2_t phase2;
+  static constexpr phase3_t phase3;
+  auto range = source | annotation{filename, line} | phase1 | phase2 | phase3;
+  return std::list<phase3_t::value_type>(range.begin(), range.end());
+}
+
+//reads physical lines until neither a backslash, a block comment nor a raw string literal continues the line
+bool read_logical_line(std::istream& is, std::string& buffer){
+  static constexpr auto is_ident = [](char c){return std::isalnum(static_cast<unsigned char>(c)) || c == '_';};
+  buffer.clear();
+  bool comment = false;
+  std::string raw;
+  std::size_t scanned = 0;
+  for(std::string physical; std::getline(is, physical);){
+    buffer += physical;
+    buffer += '\n';
+    const auto last = physical.find_last_not_of('\r');
+    if(last != std::string::npos && physical[last] == '\\')
+      continue;
+    bool number = false;
+    for(auto i = scanned; i < buffer.size(); ++i){
+      if(!raw.empty()){
+        const auto close = buffer.find(raw, i);
+        if(close == std::string::npos)
+          break;
+        i = close + raw.size() - 1;
+        raw.clear();
+        continue;
+      }
+      if(comment){
+        const auto close = buffer.find("*/", i);
+        if(close == std::string::npos)
+          break;
+        i = close + 1;
+        comment = false;
+        continue;
+      }
+      const char c = buffer[i];
+      if(!number && std::isdigit(static_cast<unsigned char>(c)) && (i == 0 || !is_ident(buffer[i-1])))
+        number = true;
+      else if(number && !is_ident(c) && c != '\'' && c != '.')
+        number = false;
+      if(c == '/' && buffer[i+1] == '*'){
+        comment = true;
+        ++i;
+      }
+      else if(c == '/' && buffer[i+1] == '/')
+        i = buffer.find('\n', i);
+      else if(c == '"' && i > 0 && buffer[i-1] == 'R'){
+        auto prefix = i - 1;
+        while(prefix > 0 && (buffer[prefix-1] == 'u' || buffer[prefix-1] == 'U' || buffer[prefix-1] == 'L' || buffer[prefix-1] == '8'))
+          --prefix;
+        if(prefix > 0 && is_ident(buffer[prefix-1])){
+          i = buffer.find_first_of("\"\n", i+1);
+          continue;
+        }
+        const auto open = buffer.find('(', i);
+        if(open == std::string::npos)
+          break;
+        raw = ')' + buffer.substr(i+1, open-i-1) + '"';
+        i = open;
+      }
+      else if((c == '"' || c == '\'') && !number){
+        for(++i; i < buffer.size() && buffer[i] != c && buffer[i] != '\n'; ++i)
+          if(buffer[i] == '\\')
+            ++i;
+      }
+    }
+    if(raw.empty() && !comment)
+      return true;
+    scanned = buffer.size();
+  }
+  return !buffer.empty();
+}
+
+std::string minimize_directives(const std::string& source){
+  static constexpr std::string_view kept[] = {"include", "if", "ifdef", "ifndef", "elif", "else", "endif", "define", "undef"};
+  std::istringstream iss{source};
+  std::string ret;
+  ret.reserve(source.size() / 8);
+  for(std::string line; read_logical_line(iss, line);){
+    auto i = line.find_first_not_of(" \t\f\v");
+    bool keep = false;
+    if(line[i] == '#'){
+      i = line.find_first_not_of(" \t\f\v", i+1);
+      const auto name = std::string_view{line}.substr(i, line.find_first_not_of("abcdefghijklmnopqrstuvwxyz", i) - i);
+      keep = std::find(std::begin(kept), std::end(kept), name) != std::end(kept);
+    }
+    if(keep)
+      ret += line;
+    else
+      ret.append(std::count(line.begin(), line.end(), '\n'), '\n');
+  }
+  return ret;
+}
+
+std::list<phase3_t::value_type> lex_pasted(const std::string& source, const annotation_type& anno){
+  auto range = source | annotation{anno} | phase3_t{};
+  return std::list<phase3_t::value_type>(range.begin(), range.end());
+}
+
+}
@@ -0,0 +1,1267 @@
+#include<messer/core.hpp>
+#include<boost/range/adaptor/indexed.hpp>
+#include<boost/coroutine2/all.hpp>
+#include<algorithm>
+
+#define RULE VEILER_PEGASUS_RULE
+#define AUTO_RULE VEILER_PEGASUS_AUTO_RULE
+#define INLINE_RULE VEILER_PEGASUS_INLINE_RULE
+
+namespace messer{
+
+struct phase4_t::preprocessing_file : veiler::pegasus::parsers<phase4_t::preprocessing_file>{
+  static auto entrypoint(){
+    return instance().group.with_skipper(*instance()._);
+  }
+  struct if_section_t;
+  struct node{
+    std::vector<std::variant<if_section_t, veiler::pegasus::iterator_range<std::list<phase3_t::value_type>::const_iterator>>> data;
+  };
+  struct if_section_t{
+    std::vector<std::tuple<veiler::pegasus::iterator_range<std::list<phase3_t::value_type>::const_iterator>, node>> data;
+  }; 
+ private:
+  static constexpr auto location = veiler::pegasus::semantic_actions::location;
+  static constexpr auto omit = veiler::pegasus::semantic_actions::omit;
+  static constexpr auto read = veiler::pegasus::read;
+  static constexpr auto value = veiler::pegasus::semantic_actions::value;
+  template<typename T>
+  static constexpr auto lit(T&& t){return veiler::pegasus::lit(std::forward<T>(t));}
+  template<typename T, typename U>
+  static constexpr auto range(T&& t, U&& u){return veiler::pegasus::range(std::forward<T>(t), std::forward<U>(u));}
+  RULE(group, node, veiler::pegasus::transient((*rules.group_part)[([](auto&& v, [[maybe_unused]] auto&&... unused){return node{std::move(v)};})]))
+  AUTO_RULE(group_part, veiler::pegasus::transient(
+      ( rules.if_section
+      | rules.other_part
+      )
+      ))
+  RULE(if_section, if_section_t, veiler::pegasus::transient(
+      (  rules.if_group
+      >> *( omit[ lit(token_type::eol)
+               >> lit(token_type::punctuator_hash)
+                ]
+         >> ( lit(token_type::identifier_elif)
+           >> rules.get_line
+            )[location]
+         >> rules.group
+          )
+      >> -( omit[ lit(token_type::eol)
+               >> lit(token_type::punctuator_hash)
+                ]
+         >> ( lit(token_type::identifier_else)
+           >> &lit(token_type::eol)[omit]
+            )[location]
+         >> rules.group
+          )
+      >> omit[ lit(token_type::eol)
+            >> lit(token_type::punctuator_hash)
+            >> lit(token_type::identifier_endif)
+            >> &lit(token_type::eol)
+             ]
+      )[([](auto&& v, [[maybe_unused]] auto&&... unused){
+         auto&& [xs, else_part] = v;
+         if(else_part)
+           xs.emplace_back(std::move(*else_part));
+         return if_section_t{std::move(xs)};
+       })]
+      ))
+  AUTO_RULE(if_group, veiler::pegasus::transient(
+      omit[ lit(token_type::eol)
+         >> lit(token_type::punctuator_hash)
+          ]
+   >> ( ( lit(token_type::identifier_if)
+       >> rules.get_line
+       >> &lit(token_type::eol)
+        )
+        |
+        ( ( lit(token_type::identifier_ifdef)
+          | lit(token_type::identifier_ifndef)
+          )
+       >> rules.identifier
+       >> &lit(token_type::eol)
+        )
+      )[location]
+   >> rules.group
+      ))
+  AUTO_RULE(other_part, veiler::pegasus::transient(
+      ( lit(token_type::eol)
+     >>  ( rules.get_line
+         - ( lit(token_type::punctuator_hash)
+          >> ( lit(token_type::identifier_if)
+             | lit(token_type::identifier_ifdef)
+             | lit(token_type::identifier_ifndef)
+             | lit(token_type::identifier_elif)
+             | lit(token_type::identifier_else)
+             | lit(token_type::identifier_endif)
+             )
+           )
+         ) % lit(token_type::eol)
+      )[location]
+      ))
+  INLINE_RULE(get_line, *(veiler::pegasus::read - veiler::pegasus::lit(token_type::eol)) >> &veiler::pegasus::lit(token_type::eol))
+  INLINE_RULE(identifier, veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return is_identifier((v++)->type());}))
+  INLINE_RULE(_, veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return (v++)->type() == token_type::white_space;}))
+};
+
+template<bool InArithmeticEvaluation>
+std::list<phase4_t::token_t> phase4_t::eval(std::list<token_t>& ls, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& r, override_annotate& override_annotation, const std::filesystem::path& current_path, bool step_flag, std::ostream& os){
+  static auto pp_directive_line = 
+       _(token_type::eol) >> *_(token_type::white_space)
+    >> _(token_type::punctuator_hash) >> *_(token_type::white_space)
+    ;
+  static auto next_pp_line = [](auto it, auto&& end){
+     for(;it != end; ++it)
+       if((&pp_directive_line)(it, end))
+         break;
+     return it;
+  };
+  struct include_data : veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{};
+  static auto rule_include = 
+       _(token_type::identifier_include) >> *_(token_type::white_space)
+    >> (+(veiler::pegasus::read - _(token_type::eol)))[veiler::pegasus::semantic_actions::omit][([](auto&&, auto&& loc, [[maybe_unused]] auto&&... unused){return include_data{loc};})];
+  using define_data = std::variant<std::tuple<std::list<token_t>::const_iterator, func_t>, std::tuple<std::list<token_t>::const_iterator, output_range<std::list<token_t>::const_iterator>>>;
+  static auto identifier = veiler::pegasus::filter([](auto&& v, [[maybe_unused]] auto&&... unused){return is_identifier((v++)->type());});
+  static auto rule_define = (
+       _(token_type::identifier_define) >> *_(token_type::white_space)
+    >> identifier
+    >> -( _(token_type::punctuator_left_parenthesis) >> *_(token_type::white_space)
+       >> (  ( identifier >> *_(token_type::white_space) )
+             % (  _(token_type::punctuator_comma) >> *_(token_type::white_space) )
+          >> ( -(  _(token_type::punctuator_comma) >> *_(token_type::white_space)
+                >> _(token_type::punctuator_ellipsis) >> *_(token_type::white_space)
+                )
+             )[([](auto&& v, [[maybe_unused]] auto&&... unused){return static_cast<bool>(v);})]
+          |  ( -( _(token_type::punctuator_ellipsis) >> *_(token_type::white_space) )
+             )[([](auto&& v, auto&& loc, [[maybe_unused]] auto&&... unused){return std::make_tuple(std::vector<std::decay_t<decltype(loc.begin())>>{}, static_cast<bool>(v));})]
+          )
+          //(), (ident, ident) or (...) or (ident, ...)
+       >> _(token_type::punctuator_right_parenthesis)
+        )
+    >> *_(token_type::white_space)
+    >> (*(veiler::pegasus::read - _(token_type::eol)))[veiler::pegasus::semantic_actions::location]
+    )[([](auto&& t, auto&& loc, [[maybe_unused]] auto&&... args)->veiler::expected<define_data, veiler::pegasus::parse_error<std::decay_t<decltype(loc.begin())>>>{
+          auto&& [name, function_info, destination] = t;
+          if(name->type() == token_type::identifier_defined)
+            return veiler::make_unexpected(veiler::pegasus::error_type::semantic_check_failed{});
+          output_range<std::list<token_t>::const_iterator> dst{destination.begin(), destination.end()};
+          if(function_info){
+            auto&& [args, is_variadic] = *function_info;
+            std::vector<int> arg_index;
+            arg_index.reserve(std::distance(dst.begin(), dst.end()));
+            {
+              std::size_t t_i = 0;
+              for(auto&& t : dst){
+                if(is_variadic && t.get() == "__VA_ARGS__"){
+                  arg_index.push_back(-static_cast<int>(args.size())-1);
+                  ++t_i;
+                  continue;
+                }
+                for(auto&& x : args | boost::adaptors::indexed())
+                  if(t.get() == x.value()->get()){
+                    arg_index.push_back(x.index()+1);
+                    break;
+                  }
+                if(t_i++ == arg_index.size())
+                  arg_index.push_back(0);
+              }
+            }
+            return define_data{std::make_tuple(std::move(name), func_t{is_variadic ? -static_cast<int>(args.size())-1 : static_cast<int>(args.size()), std::move(arg_index), dst})};
+          }
+          else
+            return define_data{std::make_tuple(std::move(name), dst)};
+        })];
+  using undef_data = std::list<token_t>::const_iterator;
+  static auto rule_undef = 
+       _(token_type::identifier_undef) >> *_(token_type::white_space)
+    >> _(token_type::identifier)[([](auto&&, auto&& loc, [[maybe_unused]] auto&&... unused)->undef_data{return loc.begin();})];
+  struct pragma_step_data : veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{};
+  static const auto rule_pragma_step =
+       _(token_type::identifier_pragma) >> *_(token_type::white_space)
+    >> _(std::string_view{"step"}) >> *_(token_type::white_space)
+    >> (*(veiler::pegasus::read - _(token_type::eol)))[([](auto&&, auto&& loc, [[maybe_unused]] auto&&... unused){return pragma_step_data{loc};})];
+  struct pragma_messer_data : veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{};
+  static const auto rule_pragma_messer =
+       _(token_type::identifier_pragma) >> *_(token_type::white_space)
+    >> _(std::string_view{"messer"}) >> *_(token_type::white_space)
+    >> (*(veiler::pegasus::read - _(token_type::eol)))[([](auto&&, auto&& loc, [[maybe_unused]] auto&&... unused){return pragma_messer_data{loc};})];
+  static auto rule_pragma = 
+       _(token_type::identifier_pragma) >> *_(token_type::white_space)
+    >> *(veiler::pegasus::read - _(token_type::eol));
+  using error_data = std::tuple<std::string_view, std::size_t, std::size_t, veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>>;
+  static auto rule_error = 
+       veiler::pegasus::lit(token_type::identifier_error)[([](auto&& v, [[maybe_unused]] auto&&... unused){return std::make_tuple(v->filename(), v->line(), v->column());})] >> *_(token_type::white_space)
+    >> (*(veiler::pegasus::read - _(token_type::eol)))[veiler::pegasus::semantic_actions::location];
+  struct line_data : veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{};
+  static auto rule_line = 
+       _(token_type::identifier_line) >> *_(token_type::white_space)
+    >> (+(veiler::pegasus::read - _(token_type::eol)))[veiler::pegasus::semantic_actions::omit][([](auto&&, auto&& loc, [[maybe_unused]] auto&&... unused){return line_data{loc};})];
+  static auto pp_directive = 
+     pp_directive_line[veiler::pegasus::semantic_actions::omit]
+  >> ( rule_include
+     | rule_define
+     | rule_undef
+     | rule_pragma_step
+     | rule_pragma_messer
+     | rule_pragma[veiler::pegasus::semantic_actions::omit]
+     | rule_error
+     | rule_line
+     | veiler::pegasus::eps[veiler::pegasus::semantic_actions::omit]
+     );
+  pp_state preprocessing_state{ls, {}};
+  std::list<token_t> result;
+  auto passed = [&](auto&& t){result.push_back(t);return true;};
+  for(auto it = r.begin(); it != r.end();)
+    if((&pp_directive_line)(it, r.end())){
+      auto copied = it;
+      if(auto ret = pp_directive(it, r.end())){
+        if(*ret){
+          struct{
+            void operator()(const include_data& i)const{
+              const auto path = s_->resolve_include(*pps_, i, current_path);
+              if(!path)
+                return;
+              auto canonicaled = path->string();
+              s_->included.emplace_back(canonicaled);
+              auto& files = s_->directives_only ? s_->directive_files : s_->files;
+              auto file = files.find(canonicaled);
+              bool loaded = false;
+              const bool inserted = file == files.end();
+              if(inserted){
+                std::shared_ptr<const token_table> shared;
+                if(s_->base && !s_->directives_only){
+                  const auto b = s_->base->files.find(canonicaled);
+                  if(b != s_->base->files.end()){
+                    shared = b->second;
+                    ++s_->stats.file_cache_hits;
+                  }
+                }
+                if(!shared){
+                  shared = s_->prefetcher.take(canonicaled, s_->directives_only);
+                  if(!shared){
+                    std::ifstream ifs{*path};
+                    std::istreambuf_iterator<char> it{ifs};
+                    static constexpr std::istreambuf_iterator<char> end{};
+                    std::string tmp(it, end);
+                    s_->prefetcher.scan(tmp, path->parent_path(), s_->directives_only);
+                    const auto filename = s_->intern(canonicaled);
+                    shared = std::make_shared<const token_table>(filename, lex(s_->directives_only ? minimize_directives(tmp) : tmp, filename));
+                  }
+                  ++s_->stats.files_loaded;
+                  loaded = true;
+                }
+                file = files.emplace(canonicaled, std::move(shared)).first;
+              }
+              else
+                ++s_->stats.file_cache_hits;
+              const auto shared = file->second;
+              auto list = shared->tokens(0, shared->size());
+              if(loaded)
+                s_->stats.lexed(list);
+              res_->splice(res_->end(), (*s_)(list, path->parent_path(), os));
+              if(s_->file_cache_bounded())
+                s_->file_usage.touch(s_->directives_only ? file_cache_usage::kind::directive_file : file_cache_usage::kind::file, canonicaled, inserted ? std::optional<std::size_t>{shared->capacity_bytes()} : std::nullopt);
+            }
+            void operator()(define_data&& d)const{
+              struct{
+                [[noreturn]] static void throw_redefine(const std::list<token_t>::const_iterator& it){
+                  std::string message(it->filename());
+                  message += ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: invalid redifinition of '";
+                  message += it->get() + '\'';
+                  throw std::runtime_error(std::move(message));
+                }
+                void operator()(std::tuple<std::list<token_t>::const_iterator, func_t>&& t)const{
+                  auto&& [name_node, func_data] = std::move(t);
+                  {
+                    auto prev_defined = s_->functions->find(name_node->get());
+                    if(prev_defined != s_->functions->end()){
+                      if(prev_defined->second.arg_num != func_data.arg_num)
+                        throw_redefine(name_node);
+                      auto prev_it = prev_defined->second.dst.begin();
+                      auto current_it = func_data.dst.begin();
+                      std::size_t idx = 0;
+                      while(true){
+                        if(prev_it == prev_defined->second.dst.end()){
+                          if(current_it != func_data.dst.end())
+                            while(current_it != func_data.dst.end())
+                              if(current_it++->type() != token_type::white_space)
+                                throw_redefine(name_node);
+                          break;
+                        }
+                        else if(current_it == func_data.dst.end()){
+                          while(prev_it != prev_defined->second.dst.end())
+                            if(prev_it++->type() != token_type::white_space)
+                              throw_redefine(name_node);
+                          break;
+                        }
+                        if(prev_it->type() != current_it->type()
+                        || (prev_it->type() != token_type::white_space && prev_it->get() != current_it->get())
+                        || prev_defined->second.arg_index[idx] != func_data.arg_index[idx])
+                          throw_redefine(name_node);
+                        ++prev_it;
+                        ++current_it;
+                        ++idx;
+                      }
+                    }
+                    else if(s_->objects->find(name_node->get()) != s_->objects->end())
+                      throw_redefine(name_node);
+                  }
+                  func_data.dst = s_->own(func_data.dst);
+                  s_->functions.write().emplace(name_node->get(), std::move(func_data));
+                  ++s_->stats.macros_defined;
+                  s_->memo.invalidate();
+                  s_->object_cache.invalidate(name_node->get());
+                }
+                void operator()(std::tuple<std::list<token_t>::const_iterator, output_range<std::list<token_t>::const_iterator>>&& t)const{
+                  auto&& [name_node, replacement_list] = std::move(t);
+                  {
+                    auto prev_defined = s_->objects->find(name_node->get());
+                    if(prev_defined != s_->objects->end()){
+                      auto prev_it = prev_defined->second.begin();
+                      auto current_it = replacement_list.begin();
+                      while(true){
+                        if(prev_it == prev_defined->second.end()){
+                          if(current_it != replacement_list.end())
+                            while(current_it != replacement_list.end())
+                              if(current_it++->type() != token_type::white_space)
+                                throw_redefine(name_node);
+                          break;
+                        }
+                        else if(current_it == replacement_list.end()){
+                          while(prev_it != prev_defined->second.end())
+                            if(prev_it++->type() != token_type::white_space)
+                              throw_redefine(name_node);
+                          break;
+                        }
+                        if(prev_it->type() != current_it->type()
+                        || (prev_it->type() != token_type::white_space && prev_it->get() != current_it->get()))
+                          throw_redefine(name_node);
+                        ++prev_it;
+                        ++current_it;
+                      }
+                    }
+                    else if(s_->functions->find(name_node->get()) != s_->functions->end())
+                      throw_redefine(name_node);
+                  }
+                  s_->objects.write().emplace(name_node->get(), s_->own(replacement_list));
+                  ++s_->stats.macros_defined;
+                  s_->memo.invalidate();
+                  s_->object_cache.invalidate(name_node->get());
+                }
+                phase4_t* s_;
+              }v{s_};
+              std::visit(v, std::move(d));
+            }
+            void operator()(const undef_data& u)const{
+              auto& s = *s_;
+              auto&& x = u->get();
+              if(s.objects->find(x) != s.objects->end()){
+                s.objects.write().erase(x);
+                ++s.stats.macros_undefined;
+                s.memo.invalidate();
+                s.object_cache.invalidate(x);
+                return;
+              }
+              if(s.functions->find(x) != s.functions->end()){
+                s.functions.write().erase(x);
+                ++s.stats.macros_undefined;
+                s.memo.invalidate();
+                s.object_cache.invalidate(x);
+              }
+            }
+            void operator()(const error_data& e)const{
+              std::stringstream ss;
+              for(auto&& x : std::get<3>(e))
+                ss << x.get();
+              throw std::runtime_error(std::string{std::get<0>(e)} + ':' + std::to_string(std::get<1>(e)) + ':' + std::to_string(std::get<2>(e)) + ": error: " + ss.str());
+            }
+            void operator()(const line_data& l)const{
+              std::list<token_t> tmp;
+              {
+                auto it = l.begin();
+                while(it != l.end())
+                  if(!eval_macro(eval_macro, [&tmp](auto&& t){tmp.push_back(t);return true;}, *s_, *pps_, it, l.end(), no_yield))
+                    {return;}
+              }
+              if(tmp.empty())
+                return;
+              constexpr auto parser = (
+                 veiler::pegasus::lit(token_type::pp_number)[([](auto&& v, [[maybe_unused]] auto&&... unused)->veiler::expected<std::size_t, veiler::pegasus::parse_error<std::list<token_t>::const_iterator>>{
+                   std::size_t idx;
+                   const auto ret = std::stoull(v->get(), &idx, 10);
+                   if(idx != v->get().size())
+                     return veiler::make_unexpected<veiler::pegasus::parse_error<std::list<token_t>::const_iterator>>(veiler::pegasus::error_type::semantic_check_failed{"line number is not decimal"});
+                   return ret;
+                 })]
+              >> -veiler::pegasus::lit(token_type::string_literal)[veiler::pegasus::semantic_actions::value]
+              ).with_skipper(*_(token_type::white_space));
+              auto cit = tmp.cbegin();
+              auto result = parser(cit, tmp.cend());
+              if(!result || cit != tmp.cend())
+                return;
+              auto&& [line_num, filename] = *result;
+              if(filename){
+                auto str_lit = string_literal::destringize(*filename);
+                if(str_lit)
+                  oa_->filename = str_lit->str;
+                else
+                  return;
+              }
+              oa_->base_line = line_num;
+              static auto next_line = [](auto it, auto end){
+                while(it != end)
+                  if(it->type() == token_type::eol)
+                    return ++it;
+                  else
+                    ++it;
+                return it;
+              };
+              const auto nit = next_line(l.end(), end);
+              oa_->org_line = nit != end ? nit->line() : std::prev(nit)->line() + 1;
+              for(auto it = nit; it != end; ++it){
+                const_cast<phase3_t::value_type&>(*it).line(oa_->base_line + it->line() - oa_->org_line);
+                if(!oa_->filename.empty())
+                  const_cast<phase3_t::value_type&>(*it).filename(oa_->filename);
+              }
+            }
+            void operator()(const pragma_step_data& p)const{
+              res_->splice(res_->end(), 
+                  s_->eval(pps_->list, static_cast<const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>&>(p), *oa_, current_path, true, os) );
+            }
+            void operator()(const pragma_messer_data& p)const{
+              std::vector<std::string_view> words;
+              for(auto&& x : p)
+                if(!is_white_spaces(x.type()))
+                  words.emplace_back(x.get());
+              if(words.size() == 1 && words[0] == "stats"){
+                s_->stats.write_text(os);
+                return;
+              }
+              if(words.size() == 1 && words[0] == "memory"){
+                s_->memory().write_text(os);
+                return;
+              }
+              if(words.size() == 2 && words[0] == "profile" && words[1] == "begin"){
+                s_->profiler = std::make_unique<expansion_profiler>();
+                return;
+              }
+              if(words.size() == 2 && words[0] == "profile" && words[1] == "end"){
+                if(s_->profiler)
+                  s_->profiler->write_text(os);
+                s_->profiler.reset();
+                return;
+              }
+              const auto it = std::prev(p.begin());
+              std::string message = std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: unknown '#pragma messer' directive:";
+              for(auto&& x : words)
+                message += ' ' + std::string{x};
+              throw std::runtime_error(std::move(message));
+            }
+            phase4_t* s_;
+            pp_state* pps_;
+            override_annotate* oa_;
+            std::list<token_t>::const_iterator end;
+            const std::filesystem::path& current_path;
+            std::list<token_t>* res_;
+            std::ostream& os;
+          }visitor{this, &preprocessing_state, &override_annotation, ls.end(), current_path, &result, os};
+          std::visit(visitor, std::move(**ret));
+        }
+        else{
+          veiler::pegasus::semantic_actions::omit[pp_directive_line](copied, r.end());
+          if(copied->type() != token_type::eol && !veiler::pegasus::semantic_actions::omit[&rule_pragma](copied, r.end())){
+            std::string message = std::string{copied->filename()} + ':' + std::to_string(copied->line()) + ':' + std::to_string(copied->column()) + ": error: invalid preprocessing directive: ";
+            for(auto it = copied; it->type() != token_type::eol; ++it)
+              message += it->get();
+            throw std::runtime_error(std::move(message));
+          }
+        }
+      }
+      else
+        ++it;
+    }
+    else if(step_flag){
+      boost::coroutines2::coroutine<std::vector<output_range<std::list<token_t>::const_iterator>>>::pull_type coroutine{[&](boost::coroutines2::coroutine<std::vector<output_range<std::list<token_t>::const_iterator>>>::push_type& yield){
+        preprocessing_state.replaced.clear();
+        const auto next_pp = next_pp_line(it, r.end());
+        while(it != next_pp)
+          if(!eval_macro.template operator()<InArithmeticEvaluation, true>(eval_macro, passed, *this, preprocessing_state, it, next_pp, [&](const phase4_t&, pp_state&, std::list<token_t>::const_iterator, const std::vector<output_range<std::list<token_t>::const_iterator>>& list){
+            yield(list);
+          }))
+          {if(diagnostic)diagnostic("eval_macro_failed");return;}
+      }};
+      std::ostringstream frame;
+      const auto emit = [&]{
+        if(step_trace)
+          step_trace(frame.str());
+        else
+          os << frame.str();
+        frame.str("");
+      };
+      const auto next_pp = next_pp_line(it, r.end());
+      frame << "   ";
+      auto pnp = std::prev(next_pp);
+      while(result.front().type() == token_type::eol)result.pop_front();
+      for(auto&& x : result)
+        if(x.type() != token_type::eol)
+          frame << x;
+        else
+          frame << "\n   ";
+      for(auto&& x : output_range<std::list<token_t>::const_iterator>{it, next_pp})
+        if(x.type() != token_type::eol || (x.line() == pnp->line() && x.column() == pnp->column()))
+          frame << x;
+        else
+          frame << "\n   ";
+      if(std::prev(next_pp)->type() != token_type::eol)
+        frame << '\n';
+      emit();
+      for(auto&& xss : coroutine){
+        frame << "-> ";
+        while(result.front().type() == token_type::eol)result.pop_front();
+        for(auto&& x : result)
+          if(x.type() != token_type::eol)
+            frame << x;
+          else
+            frame << "\n   ";
+        auto pxsse = std::prev(xss.back().end());
+        for(auto&& xs : xss)
+          for(auto&& x : xs){
+            if(x.type() != token_type::eol || (x.line() == pxsse->line() && x.column() == pxsse->column()))
+              frame << x;
+            else
+              frame << "\n   ";
+          }
+        if(pxsse->type() != token_type::eol)
+          frame << '\n';
+        emit();
+      }
+      std::list<token_t> p6;
+      {
+        phase6_t phase6;
+        const auto push = [&p6](token_t&& t){p6.push_back(std::move(t));};
+        for(auto&& x : result)
+          phase6(x, push);
+        phase6.finish(push);
+      }
+      if(!tokens_equal(result, p6)){
+        frame << "-> ";
+        for(auto&& x : p6)
+          if(x.type() != token_type::eol)
+            frame << x;
+          else
+            frame << "\n   ";
+        if(std::prev(p6.end())->type() != token_type::eol)
+          frame << '\n';
+        emit();
+      }
+      eval_pragmas(os);
+      return {};
+    }
+    else{
+      const auto next_pp = next_pp_line(it, r.end());
+      while(it != next_pp)
+        if(!eval_macro.template operator()<InArithmeticEvaluation>(eval_macro, passed, *this, preprocessing_state, it, next_pp, no_yield))
+          {if(diagnostic)diagnostic("eval_macro_failed"); return decltype(result){};}
+      eval_pragmas(os);
+    }
+  {
+    memory_usage m;
+    m.hide_sets = memory_usage::of(preprocessing_state.replaced, [](auto&& x){return memory_usage::of(x.second);});
+    m.temporaries = result.size() * memory_usage::list_node;
+    transient_memory.peak(m);
+  }
+  return result;
+}
+
+template std::list<phase4_t::token_t> phase4_t::eval<false>(std::list<token_t>&, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>&, override_annotate&, const std::filesystem::path&, bool, std::ostream&);
+template std::list<phase4_t::token_t> phase4_t::eval<true>(std::list<token_t>&, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>&, override_annotate&, const std::filesystem::path&, bool, std::ostream&);
+
+std::string phase4_t::expansion_memo::key(std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, const hide_set_map& replaced){
+  std::string ret;
+  const auto append = [&](std::string_view str){
+    const auto size = str.size();
+    ret.append(reinterpret_cast<const char*>(&size), sizeof(size)).append(str);
+  };
+  for(; it != end; ++it){
+    const auto type = static_cast<std::underlying_type_t<token_type>>(it->type());
+    ret.append(reinterpret_cast<const char*>(&type), sizeof(type));
+    append(it->get());
+    const auto r = replaced.find(it);
+    const std::size_t hide_set_size = r == replaced.end() ? 0 : r->second.size();
+    ret.append(reinterpret_cast<const char*>(&hide_set_size), sizeof(hide_set_size));
+    if(r != replaced.end())
+      for(auto&& x : r->second)
+        append(x);
+  }
+  return ret;
+}
+
+const phase4_t::expansion_memo::entry* phase4_t::expansion_memo::find(const std::string& key)const{
+  const auto it = entries.find(key);
+  if(it != entries.end())
+    return &it->second;
+  return base ? base->find(key) : nullptr;
+}
+
+std::list<phase4_t::token_t> phase4_t::expansion_memo::load(const entry& e, std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, hide_set_map& replaced, token_pool& pool){
+  std::vector<std::list<token_t>::const_iterator> invocation;
+  for(auto i = std::next(it); i != end; ++i)
+    invocation.emplace_back(i);
+  auto ret = pool.copy(e.tokens.begin(), e.tokens.end());
+  std::size_t i = 0;
+  for(auto t = ret.begin(); t != ret.end(); ++t, ++i){
+    t->annotation() = e.origin[i] < 0 ? it->annotation() : invocation[e.origin[i]]->annotation();
+    replaced[t] = e.replaced[i];
+  }
+  return ret;
+}
+
+void phase4_t::expansion_memo::store(std::string&& key, std::list<token_t>::const_iterator it, std::list<token_t>::const_iterator end, const std::list<token_t>& expanded, const hide_set_map& replaced){
+  if(entries.size() >= max_entries)
+    entries.clear();
+  std::map<std::tuple<const char*, std::size_t, std::size_t>, std::ptrdiff_t> origins;
+  std::ptrdiff_t index = 0;
+  for(auto i = std::next(it); i != end; ++i, ++index)
+    origins.emplace(std::make_tuple(i->filename().data(), i->line(), i->column()), index);
+  entry e{expanded, {}, {}};
+  e.replaced.reserve(expanded.size());
+  e.origin.reserve(expanded.size());
+  for(auto t = expanded.cbegin(); t != expanded.cend(); ++t){
+    const auto r = replaced.find(t);
+    e.replaced.emplace_back(r == replaced.end() ? std::vector<std::string>{} : r->second);
+    const auto o = origins.find(std::make_tuple(t->filename().data(), t->line(), t->column()));
+    e.origin.emplace_back(o == origins.end() ? -1 : o->second);
+  }
+  entries.emplace(std::move(key), std::move(e));
+}
+
+const phase4_t::object_expansion_cache::entry* phase4_t::object_expansion_cache::find(const std::string& name)const{
+  const auto it = entries.find(name);
+  if(it != entries.end())
+    return &it->second;
+  return base ? base->find(name) : nullptr;
+}
+
+void phase4_t::object_expansion_cache::store(const std::string& name, entry& slot, entry&& e){
+  std::sort(e.dependencies.begin(), e.dependencies.end());
+  e.dependencies.erase(std::unique(e.dependencies.begin(), e.dependencies.end()), e.dependencies.end());
+  for(auto&& x : e.dependencies)
+    dependents[x].emplace_back(name);
+  slot = std::move(e);
+}
+
+void phase4_t::object_expansion_cache::invalidate(const std::string& name){
+  for(auto b = base; b; b = b->base)
+    if(b->dependents.find(name) != b->dependents.end()){
+      base = nullptr;
+      break;
+    }
+  const auto it = dependents.find(name);
+  if(it == dependents.end())
+    return;
+  for(auto&& x : it->second)
+    entries.erase(x);
+  dependents.erase(it);
+}
+
+phase4_t::include_prefetcher::worker_pool::~worker_pool(){
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    stopping = true;
+  }
+  jobs_available.notify_all();
+  for(auto&& x : threads)
+    x.join();
+}
+
+void phase4_t::include_prefetcher::worker_pool::push(include_prefetcher& owner, std::vector<job>&& found){
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if(threads.empty()){
+      const auto n = std::thread::hardware_concurrency();
+      if(n < 2)
+        return;
+      for(unsigned i = 1; i < std::min(n, 8u); ++i)
+        threads.emplace_back([this]{work();});
+    }
+    for(auto&& x : found)
+      jobs.emplace_back(&owner, std::move(x));
+  }
+  jobs_available.notify_all();
+}
+
+void phase4_t::include_prefetcher::worker_pool::cancel(include_prefetcher& owner){
+  std::unique_lock<std::mutex> lock{mutex};
+  const auto drop = [&]{jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&](auto&& x){return x.first == &owner;}), jobs.end());};
+  drop();
+  idle.wait(lock, [&]{return owner.running == 0;});
+  //the running jobs may have queued the headers they include
+  drop();
+}
+
+void phase4_t::include_prefetcher::worker_pool::work(){
+  while(true){
+    std::pair<include_prefetcher*, job> j;
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      jobs_available.wait(lock, [&]{return stopping || !jobs.empty();});
+      if(stopping)
+        return;
+      j = std::move(jobs.front());
+      jobs.pop_front();
+      ++j.first->running;
+    }
+    j.first->work(std::move(j.second));
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      --j.first->running;
+    }
+    idle.notify_all();
+  }
+}
+
+phase4_t::include_prefetcher::include_prefetcher(const phase4_t& state):
+  state{state},
+  workers{state.base ? state.base->prefetcher.workers : std::make_shared<worker_pool>()}{}
+
+phase4_t::include_prefetcher::~include_prefetcher(){
+  workers->cancel(*this);
+}
+
+void phase4_t::include_prefetcher::stop(){
+  workers->cancel(*this);
+  clear();
+}
+
+void phase4_t::include_prefetcher::clear(){
+  std::lock_guard<std::mutex> lock{mutex};
+  ++generation;
+  results.clear();
+  seen.clear();
+}
+
+void phase4_t::include_prefetcher::scan(std::string_view source, const std::filesystem::path& current_path, bool minimize){
+  std::size_t current;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    current = generation;
+  }
+  scan(source, current_path, minimize, current);
+}
+
+void phase4_t::include_prefetcher::scan(std::string_view source, const std::filesystem::path& current_path, bool minimize, std::size_t generation){
+  std::vector<job> found;
+  for(std::size_t pos = 0; pos < source.size();){
+    const auto eol = std::min(source.find('\n', pos), source.size());
+    auto line = source.substr(pos, eol - pos);
+    pos = eol + 1;
+    const auto skip = [&line]{line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));};
+    skip();
+    if(line.substr(0, 1) != "#")
+      continue;
+    line.remove_prefix(1);
+    skip();
+    if(line.substr(0, 7) != "include")
+      continue;
+    line.remove_prefix(7);
+    skip();
+    if(line.empty() || (line[0] != '<' && line[0] != '"'))
+      continue;
+    const auto close = line.find(line[0] == '<' ? '>' : '"', 1);
+    if(close != std::string_view::npos)
+      found.emplace_back(job{std::string{line.substr(1, close-1)}, line[0] == '<', current_path, minimize, generation});
+  }
+  if(found.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if(generation != this->generation)
+      return;
+  }
+  workers->push(*this, std::move(found));
+}
+
+void phase4_t::include_prefetcher::work(job&& j){
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if(j.generation != generation)
+      return;
+  }
+  std::string canonical;
+  bool owned = false;
+  std::shared_ptr<const token_table> tokens;
+  try{
+    const auto path = state.find_include_path(j.header, j.is_angle, j.current_path);
+    if(!path)
+      return;
+    canonical = path->string();
+    //the base does not change while its snapshots are in use
+    if(!j.minimize && state.base && state.base->files.find(canonical) != state.base->files.end())
+      return;
+    std::string_view filename;
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if(j.generation != generation || !seen.emplace(canonical).second)
+        return;
+      filename = *filenames.emplace(canonical).first;
+      auto& e = results[canonical];
+      e.minimized = j.minimize;
+      owned = true;
+    }
+    std::ifstream ifs{*path};
+    const std::string source{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+    scan(source, path->parent_path(), j.minimize, j.generation);
+    tokens = std::make_shared<const token_table>(filename, lex(j.minimize ? minimize_directives(source) : source, filename));
+  }catch(...){
+    //the evaluator loads the file itself and reports the error
+    tokens.reset();
+  }
+  if(!owned)
+    return;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    //the entry is gone once the run which queued the job has ended
+    const auto it = results.find(canonical);
+    if(j.generation != generation || it == results.end())
+      return;
+    it->second.tokens = std::move(tokens);
+    it->second.ready = true;
+  }
+  loaded.notify_all();
+}
+
+std::shared_ptr<const token_table> phase4_t::include_prefetcher::take(const std::string& canonical, bool minimized){
+  std::unique_lock<std::mutex> lock{mutex};
+  seen.emplace(canonical);
+  const auto it = results.find(canonical);
+  if(it == results.end())
+    return nullptr;
+  auto& e = it->second;
+  loaded.wait(lock, [&e]{return e.ready;});
+  auto ret = e.minimized == minimized ? std::move(e.tokens) : nullptr;
+  results.erase(canonical);
+  return ret;
+}
+
+void phase4_t::eval_pragmas(std::ostream& os){
+  for(std::vector<std::string> bodies; !pragmas.empty(); bodies.clear()){
+    bodies.swap(pragmas);
+    for(auto&& x : bodies){
+      auto tokens = lex("#pragma " + x, "<pragma operator scratch>");
+      override_annotate oa{};
+      eval(tokens, veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{tokens.cbegin(), tokens.cend()}, oa, std::filesystem::current_path(), false, os);
+    }
+  }
+}
+
+phase4_t::phase4_t(const phase4_t* base):
+  system_include_dir{base->system_include_dir},
+  include_dir{base->include_dir},
+  include_paths{base->include_paths},
+  base{base},
+  objects{base->objects},
+  functions{base->functions}{
+  file_cache_capacity = base->file_cache_capacity;
+  memo.base = &base->memo;
+  object_cache.base = &base->object_cache;
+}
+
+memory_usage phase4_t::memory()const{
+  memory_usage ret;
+  ret.hide_sets = transient_memory.hide_sets;
+  ret.temporaries = transient_memory.temporaries;
+  const auto shared_with_base = [this](auto&& x){
+    if(!base)
+      return false;
+    const auto b = base->files.find(x.first);
+    return b != base->files.end() && b->second == x.second;
+  };
+  const auto lists = [&](auto&& x){return memory_usage::of(x.first) + (shared_with_base(x) ? 0 : x.second->capacity_bytes());};
+  ret.files = memory_usage::of(files, lists) + memory_usage::of(directive_files, lists);
+  ret.files += memory_usage::of(sources, [](auto&& x){return memory_usage::of(x.first) + x.second.capacity_bytes();});
+  if(!base || !objects.shares(base->objects))
+    ret.macros = memory_usage::of(*objects, [](auto&& x){return memory_usage::of(x.first);});
+  if(!base || !functions.shares(base->functions))
+    ret.macros += memory_usage::of(*functions, [](auto&& x){return memory_usage::of(x.first) + memory_usage::of(x.second.arg_index);});
+  ret.macros += memory_usage::of(replacement_lists, [](auto&& x){
+    const auto tokens = x.second.lock();
+    return memory_usage::of(x.first) + (tokens ? memory_usage::of(*tokens) : 0);
+  });
+  ret.caches = memory_usage::of(memo.entries, [](auto&& x){return memory_usage::of(x.first) + memory_usage::of(x.second.tokens) + memory_usage::of(x.second.replaced) + memory_usage::of(x.second.origin);});
+  ret.caches += memory_usage::of(object_cache.entries, [](auto&& x){return memory_usage::of(x.first) + memory_usage::of(x.second.tokens) + memory_usage::of(x.second.replaced) + memory_usage::of(x.second.dependencies);});
+  ret.caches += memory_usage::of(object_cache.dependents, [](auto&& x){return memory_usage::of(x.first) + memory_usage::of(x.second);});
+  if(!base || !include_paths.shares(base->include_paths))
+    ret.caches += memory_usage::of(*include_paths, [](auto&& x){return memory_usage::of(x.first) + (x.second ? memory_usage::of(x.second->native()) : 0);});
+  ret.caches += pool.spares() * memory_usage::list_node;
+  return ret;
+}
+
+void phase4_t::set_file_cache_capacity(std::size_t bytes){
+  const bool was_bounded = file_cache_bounded();
+  file_cache_capacity = bytes;
+  if(!file_cache_bounded())
+    file_usage = {};
+  else if(!was_bounded){
+    for(auto&& x : files)
+      file_usage.touch(file_cache_usage::kind::file, x.first, x.second->capacity_bytes());
+    for(auto&& x : directive_files)
+      file_usage.touch(file_cache_usage::kind::directive_file, x.first, x.second->capacity_bytes());
+    for(auto&& x : sources)
+      file_usage.touch(file_cache_usage::kind::source, x.first, x.second.capacity_bytes());
+  }
+  evict_files();
+}
+
+void phase4_t::evict_files(){
+  while(file_usage.bytes > file_cache_capacity){
+    const auto& [kind, path] = file_usage.order.front();
+    if(kind == file_cache_usage::kind::file)
+      files.erase(path);
+    else if(kind == file_cache_usage::kind::directive_file)
+      directive_files.erase(path);
+    else
+      sources.erase(path);
+    const auto e = file_usage.entries.find(file_usage.order.front());
+    file_usage.bytes -= e->second.second;
+    file_usage.entries.erase(e);
+    file_usage.order.pop_front();
+    ++stats.files_evicted;
+  }
+}
+
+phase4_t::replacement_list phase4_t::own(const output_range<std::list<token_t>::const_iterator>& r){
+  std::string key;
+  for(auto&& x : r){
+    const auto size = x.get().size();
+    key += static_cast<char>(x.type());
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key += x.get();
+  }
+  if(replacement_lists.size() >= replacement_lists_sweep){
+    for(auto it = replacement_lists.begin(); it != replacement_lists.end();)
+      if(it->second.expired())
+        it = replacement_lists.erase(it);
+      else
+        ++it;
+    replacement_lists_sweep = std::max(replacement_lists_sweep, replacement_lists.size() * 2);
+  }
+  auto& slot = replacement_lists[std::move(key)];
+  auto tokens = slot.lock();
+  if(!tokens){
+    tokens = std::make_shared<const std::list<token_t>>(r.begin(), r.end());
+    slot = tokens;
+  }
+  return {{tokens->begin(), tokens->end()}, tokens};
+}
+
+bool phase4_t::condition_holds(std::list<token_t>& ls, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& directive, override_annotate& override_annotation, const std::filesystem::path& current_path, std::ostream& os){
+  auto it = directive.begin();
+  do{
+    ++it;
+  }while(it->type() == token_type::white_space);
+  ++stats.if_evaluations;
+  switch(directive.begin()->type()){
+  case token_type::identifier_if:
+  case token_type::identifier_elif:{
+    const auto ae = evaluate_condition(eval<true>(ls, veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{it, directive.end()}, override_annotation, current_path, false, os), current_path);
+    if(!ae){
+      std::string message = std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: invalid expression: ";
+      for(auto&& x : veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>{it, directive.end()})
+        message += x.get();
+      throw std::runtime_error(std::move(message));
+    }
+    return *ae != 0;
+  }
+  case token_type::identifier_ifdef:
+  case token_type::identifier_ifndef:{
+    if(!is_identifier(it->type()))
+      throw std::runtime_error(std::string{it->filename()} + ':' + std::to_string(it->line()) + ':' + std::to_string(it->column()) + ": error: macro name missing");
+    if(it->type() == token_type::identifier_has_include)
+      return directive.begin()->type() == token_type::identifier_ifdef;
+    const bool defined = functions->find(it->get()) != functions->end() || objects->find(it->get()) != objects->end();
+    return defined == (directive.begin()->type() == token_type::identifier_ifdef);
+  }
+  default:
+    return false;
+  }
+}
+
+std::optional<std::filesystem::path> phase4_t::resolve_include(pp_state& state, const veiler::pegasus::iterator_range<std::list<token_t>::const_iterator>& header, const std::filesystem::path& current_path){
+  std::list<token_t> tmp;
+  for(auto it = header.begin(); it != header.end();)
+    if(!eval_macro(eval_macro, [&tmp](auto&& t){tmp.push_back(t);return true;}, *this, state, it, header.end(), no_yield))
+      return std::nullopt;
+  if(tmp.empty())
+    return std::nullopt;
+  auto key = current_path.string();
+  for(auto&& x : tmp)
+    key += '\0' + x.get();
+  ++stats.include_lookups;
+  auto cached = include_paths->find(key);
+  if(cached == include_paths->end())
+    cached = include_paths.write().emplace(std::move(key), find_include_path(tmp, current_path)).first;
+  else
+    ++stats.include_lookup_hits;
+  const auto& path = cached->second;
+  if(!path){
+    auto message = std::string{tmp.begin()->filename()} + ':' + std::to_string(tmp.begin()->line()) + ':' + std::to_string(tmp.begin()->column()) + ": fatal error: ";
+    for(auto&& x : tmp)
+      message += x.get();
+    message += ": No such file or directory";
+    throw std::runtime_error(std::move(message));
+  }
+  return path;
+}
+
+std::list<phase4_t::token_t> phase4_t::operator()(std::list<token_t>& ls, const std::filesystem::path& current_path, std::ostream& os){
+  auto if_group = preprocessing_file::entrypoint()(std::as_const(ls));
+  if(!if_group){
+    if(diagnostic)
+      diagnostic("parsing for file structure failed");
+    return std::list<phase3_t::value_type>{};
+  }
+  override_annotate override_annotation = {};
+  struct{
+    using list = std::list<phase3_t::value_type>;
+    using iterator = list::const_iterator;
+    using iterator_range = veiler::pegasus::iterator_range<iterator>;
+    list operator()(const preprocessing_file::node& n)const{
+      list l;
+      for(auto&& x : n.data)
+        l.splice(l.end(), std::visit(*this, x));
+      return l;
+    }
+    list operator()(const iterator_range& other_part)const{
+      using veiler::pegasus::lit;
+      return self->eval(*ls_p, other_part, *oa, *cp, false, *os);
+    }
+    list operator()(const preprocessing_file::if_section_t& if_section)const{
+      for(auto&& [range, node] : if_section.data)
+        if(range.begin()->type() == token_type::identifier_else || self->condition_holds(*ls_p, range, *oa, *cp, *os))
+          return (*this)(node);
+      return list{};
+    }
+    phase4_t* self;
+    std::list<phase3_t::value_type>* ls_p;
+    override_annotate* oa;
+    const std::filesystem::path* cp;
+    std::ostream* os;
+  }visitor{this, &ls, &override_annotation, &current_path, &os};
+  auto ret = visitor(*if_group);
+  if(!ret.empty() && ret.begin()->type() == token_type::eol)
+    ret.erase(ret.begin()); //first eol
+  return ret;
+}
+
+static bool looks_like_directive(std::string_view line){
+  const auto i = line.find_first_not_of(" \t\f\v");
+  return i != std::string_view::npos && line[i] == '#';
+}
+
+phase4_t::source_file::source_file(std::istream& is, std::string_view filename):table{filename}{
+  for(std::string buffer; read_logical_line(is, buffer);){
+    const auto newlines = static_cast<std::size_t>(std::count(buffer.begin(), buffer.end(), '\n'));
+    const bool directive = looks_like_directive(buffer);
+    lines.push_back(line{std::move(buffer), newlines, directive});
+  }
+}
+
+std::list<phase4_t::token_t> phase4_t::source_file::tokens(std::size_t index, std::size_t number){
+  auto& l = lines[index];
+  if(!l.lexed){
+    l.first = table.size();
+    for(auto&& x : lex(l.text, table.filename(), number))
+      table.push_back(x);
+    l.last = table.size();
+    l.lexed = true;
+    l.directive = table.find_directive(l.first, l.last) != l.last;
+    std::string{}.swap(l.text);
+  }
+  return table.tokens(l.first, l.last);
+}
+
+//reads the lines of a stream and lexes each of them once
+struct phase4_t::stream_lines{
+  std::istream& is;
+  std::string_view filename;
+  phase4_t& self;
+  std::string buffer;
+  bool next(){return read_logical_line(is, buffer);}
+  bool directive()const{return looks_like_directive(buffer);}
+  std::size_t newlines()const{return std::count(buffer.begin(), buffer.end(), '\n');}
+  std::list<token_t> tokens(const override_annotate& oa, std::size_t line){
+    auto ret = lex(buffer, oa.filename.empty() ? filename : self.intern(oa.filename), oa.base_line + line - oa.org_line);
+    self.stats.lexed(ret);
+    return ret;
+  }
+};
+
+//copies the lines of a source_file, which are lexed when they are first needed
+struct phase4_t::file_lines{
+  source_file& file;
+  phase4_t& self;
+  std::size_t index = static_cast<std::size_t>(-1);
+  bool next(){return ++index < file.lines.size();}
+  bool directive()const{return file.lines[index].directive;}
+  std::size_t newlines()const{return file.lines[index].newlines;}
+  std::list<token_t> tokens(const override_annotate& oa, std::size_t line){
+    const bool cached = file.lines[index].lexed;
+    auto ret = file.tokens(index, line);
+    if(!cached)
+      self.stats.lexed(ret);
+    if(oa.filename.empty() && oa.base_line == oa.org_line)
+      return ret;
+    const auto filename = oa.filename.empty() ? file.table.filename() : self.intern(oa.filename);
+    for(auto&& x : ret)
+      x.filename(filename).line(oa.base_line + x.line() - oa.org_line);
+    return ret;
+  }
+};
+
+void phase4_t::stream(std::istream& is, std::string_view filename, const std::filesystem::path& current_path, const std::function<void(std::list<token_t>&&)>& sink, std::ostream& os){
+  stream_lines lines{is, filename, *this, {}};
+  process_lines(lines, filename, current_path, sink, os);
+}
+
+template<typename Lines>
+void phase4_t::process_lines(Lines& lines, std::string_view filename, const std::filesystem::path& current_path, const std::function<void(std::list<token_t>&&)>& sink, std::ostream& os){
+  using iterator = std::list<token_t>::const_iterator;
+  using iterator_range = veiler::pegasus::iterator_range<iterator>;
+  override_annotate override_annotation = {};
+  //active: the current group is processed, pending: no group of the section is taken yet, done: skipped to #endif
+  enum class condition{active, pending, done};
+  std::vector<condition> conditions;
+  const auto active = [&]{return conditions.empty() || conditions.back() == condition::active;};
+  //text lines which wait for the rest of a macro invocation
+  std::list<token_t> pending;
+  long parentheses = 0;
+  const auto names_function = [&](auto first, auto last){
+    const auto tail = std::find_if(first, last, [](auto&& t){return !is_white_spaces(t.type());});
+    return tail != last && functions->find(tail->get()) != functions->end();
+  };
+  //unless `force`, keeps the lines pending when their expansion ends in the name of a function-like macro, the next line may hold its arguments
+  const auto flush = [&](bool force){
+    if(pending.empty())
+      return;
+    std::list<token_t> raw;
+    if(!force && std::any_of(pending.cbegin(), pending.cend(), [&](auto&& t){return is_identifier(t.type()) && (objects->find(t.get()) != objects->end() || functions->find(t.get()) != functions->end());}))
+      raw = pending;
+    auto result = eval(pending, iterator_range{pending.cbegin(), pending.cend()}, override_annotation, current_path, false, os);
+    if(!raw.empty() && names_function(result.crbegin(), result.crend())){
+      pending = std::move(raw);
+      return;
+    }
+    pending.clear();
+    parentheses = 0;
+    if(!result.empty() && result.front().type() == token_type::eol)
+      result.pop_front();
+    if(!result.empty())
+      sink(std::move(result));
+  };
+  for(std::size_t line = 1; lines.next(); line += lines.newlines()){
+    //skipped groups are lexed only for their directives
+    if(!active() && !lines.directive())
+      continue;
+    auto tokens = lines.tokens(override_annotation, line);
+    const auto skip = [end = tokens.cend()](iterator it){
+      while(it != end && it->type() == token_type::white_space)
+        ++it;
+      return it;
+    };
+    const auto hash = skip(std::next(tokens.cbegin()));
+    if(hash == tokens.cend() || hash->type() != token_type::punctuator_hash){
+      if(!active())
+        continue;
+      if(!pending.empty())
+        tokens.pop_front();
+      for(auto&& x : tokens)
+        if(x.type() == token_type::punctuator_left_parenthesis)
+          ++parentheses;
+        else if(x.type() == token_type::punctuator_right_parenthesis)
+          --parentheses;
+      const bool invocation_name = names_function(tokens.crbegin(), tokens.crend());
+      pending.splice(pending.end(), tokens);
+      if(parentheses <= 0 && !invocation_name)
+        flush(false);
+      continue;
+    }
+    flush(true);
+    const auto directive = skip(std::next(hash));
+    const auto eol = std::find_if(directive, tokens.cend(), [](auto&& t){return t.type() == token_type::eol;});
+    const auto directive_error = [&](std::string_view what){
+      return std::runtime_error(std::string{hash->filename()} + ':' + std::to_string(hash->line()) + ':' + std::to_string(hash->column()) + ": error: " + std::string{what});
+    };
+    switch(directive == tokens.cend() ? token_type::eol : directive->type()){
+    case token_type::identifier_if:
+    case token_type::identifier_ifdef:
+    case token_type::identifier_ifndef:
+      if(!active())
+        conditions.emplace_back(condition::done);
+      else
+        conditions.emplace_back(condition_holds(tokens, iterator_range{directive, eol}, override_annotation, current_path, os) ? condition::active : condition::pending);
+      break;
+    case token_type::identifier_elif:
+      if(conditions.empty())
+        throw directive_error("#elif without #if");
+      if(conditions.back() == condition::active)
+        conditions.back() = condition::done;
+      else if(conditions.back() == condition::pending && condition_holds(tokens, iterator_range{directive, eol}, override_annotation, current_path, os))
+        conditions.back() = condition::active;
+      break;
+    case token_type::identifier_else:
+      if(conditions.empty())
+        throw directive_error("#else without #if");
+      conditions.back() = conditions.back() == condition::pending ? condition::active : condition::done;
+      break;
+    case token_type::identifier_endif:
+      if(conditions.empty())
+        throw directive_error("#endif without #if");
+      conditions.pop_back();
+      break;
+    case token_type::identifier_include:{
+      if(!active())
+        break;
+      pp_state state{tokens, {}};
+      const auto path = resolve_include(state, iterator_range{skip(std::next(directive)), eol}, current_path);
+      if(!path)
+        break;
+      included.emplace_back(path->string());
+      auto source = sources.find(path->string());
+      if(source == sources.end()){
+        std::ifstream ifs{*path};
+        source = sources.emplace(path->string(), source_file{ifs, intern(path->string())}).first;
+        ++stats.files_loaded;
+      }
+      else
+        ++stats.file_cache_hits;
+      file_lines included_lines{source->second, *this};
+      process_lines(included_lines, source->second.table.filename(), path->parent_path(), sink, os);
+      //the table grows as the lines are lexed
+      if(file_cache_bounded())
+        file_usage.touch(file_cache_usage::kind::source, source->first, source->second.capacity_bytes());
+    }break;
+    default:{
+      if(!active())
+        break;
+      const bool line_directive = directive->type() == token_type::identifier_line;
+      const auto org_line = std::exchange(override_annotation.org_line, line_directive ? 0 : override_annotation.org_line);
+      auto result = eval(tokens, iterator_range{tokens.cbegin(), tokens.cend()}, override_annotation, current_path, false, os);
+      //eval counts from the renumbered line of the directive, the following lines are lexed with their physical numbers
+      if(line_directive)
+        override_annotation.org_line = override_annotation.org_line == 0 ? org_line : line + lines.newlines();
+      if(!result.empty() && result.front().type() == token_type::eol)
+        result.pop_front();
+      if(!result.empty())
+        sink(std::move(result));
+    }
+    }
+  }
+  flush(true);
+  if(!conditions.empty())
+    throw std::runtime_error(std::string{filename} + ": error: unterminated conditional directive");
+}
+
+}
+
+#undef INLINE_RULE
+#undef AUTO_RULE
+#undef RULE
@@ -0,0 +1,247 @@
+#include<messer/messer.hpp>
+#include<messer/core.hpp>
+#include<unordered_set>
+
+namespace messer{
+
+token_sink write_to(std::ostream& os){
+  return [&os](const token_view& t){os << t.spelling;};
+}
+
+struct preprocessor::impl{
+  phase4_t state;
+  std::ostream* os = &std::cout;
+  impl(){
+    state.diagnostic = [](std::string_view message){std::cerr << message << std::endl;};
+  }
+  impl(const phase4_t* base, std::ostream* os):state{base}, os{os}{
+    state.diagnostic = base->diagnostic;
+  }
+  static auto to(const token_sink& sink){
+    return [&sink](const phase3_t::value_type& x){
+      if(sink)
+        sink(token_view{x.type(), x.get(), x.filename(), x.line(), x.column()});
+    };
+  }
+  void run(std::string_view source, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path){
+    struct restore{
+      phase4_t& s;
+      ~restore(){s.prefetcher.clear();}
+    }_{state};
+    state.prefetcher.scan(source, current_path, state.directives_only);
+    auto tokens = lex(std::string{source}, state.intern(filename));
+    state.stats.lexed(tokens);
+    auto result = state(tokens, current_path, *os);
+    const auto pass = to(sink);
+    phase6_t phase6;
+    for(auto&& x : result)
+      phase6(std::move(x), pass);
+    phase6.finish(pass);
+    state.evict_files();
+  }
+  void run(std::istream& is, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path){
+    const auto pass = to(sink);
+    phase6_t phase6;
+    state.stream(is, state.intern(filename), current_path, [&](std::list<phase3_t::value_type>&& lines){
+      for(auto&& x : lines)
+        phase6(std::move(x), pass);
+    }, *os);
+    phase6.finish(pass);
+    state.evict_files();
+  }
+};
+
+preprocessor::preprocessor():pimpl{std::make_unique<impl>()}{}
+preprocessor::preprocessor(preprocessor&&)noexcept = default;
+preprocessor& preprocessor::operator=(preprocessor&&)noexcept = default;
+preprocessor::~preprocessor() = default;
+
+preprocessor preprocessor::snapshot()const{
+  preprocessor ret;
+  ret.pimpl = std::make_unique<impl>(&pimpl->state, pimpl->os);
+  return ret;
+}
+
+void preprocessor::add_include_dir(const std::filesystem::path& dir){
+  pimpl->state.prefetcher.stop();
+  pimpl->state.include_dir.emplace_back(dir);
+  pimpl->state.include_paths = {};
+}
+
+void preprocessor::add_system_include_dir(const std::filesystem::path& dir){
+  pimpl->state.prefetcher.stop();
+  pimpl->state.system_include_dir.emplace_back(dir);
+  pimpl->state.include_paths = {};
+}
+
+const std::vector<std::filesystem::path>& preprocessor::include_dirs()const{
+  return pimpl->state.include_dir;
+}
+
+const std::vector<std::filesystem::path>& preprocessor::system_include_dirs()const{
+  return pimpl->state.system_include_dir;
+}
+
+void preprocessor::add_host_defaults(){
+  const char* additional_include_dirs[] = {
+    #include "include_dir.ipp"
+  };
+  for(auto x : additional_include_dirs)
+    add_system_include_dir(x);
+  static constexpr const char* predefined_macros = R"code(
+#define __cplusplus 201703L
+#define __STDC_HOSTED__ 1
+#define __STDCPP_DEFAULT_NEW_ALIGNMENT__ 16
+#if __has_include(<stdc-predef.h>)
+#include<stdc-predef.h>
+#else
+#define __STDC_ISO_10646__ 199712L
+#endif
+#define __x86_64__ 1 // TODO: specify for the environment
+#define __LP64__ 1   // TODO: ditto
+  )code";
+  preprocess(predefined_macros, "<predefined-macros>", {});
+}
+
+void preprocessor::define(std::string_view definition){
+  preprocess("#define " + std::string{definition} + '\n', "<command-line>", {});
+}
+
+void preprocessor::undef(std::string_view name){
+  preprocess("#undef " + std::string{name} + '\n', "<command-line>", {});
+}
+
+bool preprocessor::is_defined(std::string_view name)const{
+  const std::string str{name};
+  return pimpl->state.objects->find(str) != pimpl->state.objects->end() || pimpl->state.functions->find(str) != pimpl->state.functions->end();
+}
+
+std::vector<std::string> preprocessor::macro_names()const{
+  std::vector<std::string> ret;
+  ret.reserve(pimpl->state.objects->size());
+  for(auto&& x : *pimpl->state.objects)
+    ret.emplace_back(x.first);
+  return ret;
+}
+
+std::vector<std::string> preprocessor::function_macro_names()const{
+  std::vector<std::string> ret;
+  ret.reserve(pimpl->state.functions->size());
+  for(auto&& x : *pimpl->state.functions)
+    ret.emplace_back(x.first);
+  return ret;
+}
+
+void preprocessor::set_file_cache_limit(std::size_t bytes){
+  pimpl->state.set_file_cache_capacity(bytes);
+}
+
+void preprocessor::set_output(std::ostream& os){
+  pimpl->os = &os;
+}
+
+void preprocessor::set_diagnostic_handler(diagnostic_handler handler){
+  pimpl->state.diagnostic = std::move(handler);
+}
+
+void preprocessor::load_file(const std::filesystem::path& path){
+  preprocess_file(path, {});
+}
+
+void preprocessor::preprocess_file(const std::filesystem::path& path, const token_sink& sink){
+  std::ifstream ifs{path};
+  if(!ifs)
+    throw std::runtime_error(path.string() + ": fatal error: No such file or directory");
+  const std::string source{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+  pimpl->state.begin_unit();
+  pimpl->run(source, path.string(), sink, path.parent_path());
+}
+
+void preprocessor::scan_file(const std::filesystem::path& path){
+  std::ifstream ifs{path};
+  if(!ifs)
+    throw std::runtime_error(path.string() + ": fatal error: No such file or directory");
+  const std::string source{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+  struct restore{
+    phase4_t& s;
+    ~restore(){s.directives_only = false;}
+  }_{pimpl->state};
+  pimpl->state.directives_only = true;
+  pimpl->state.begin_unit();
+  pimpl->run(minimize_directives(source), path.string(), {}, path.parent_path());
+}
+
+std::vector<std::filesystem::path> preprocessor::dependencies()const{
+  std::vector<std::filesystem::path> ret;
+  std::unordered_set<std::string_view> seen;
+  for(auto&& x : pimpl->state.included)
+    if(seen.emplace(x).second)
+      ret.emplace_back(x);
+  return ret;
+}
+
+void preprocessor::preprocess_stream(std::istream& is, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path){
+  pimpl->state.begin_unit();
+  pimpl->run(is, filename, sink, current_path);
+}
+
+void preprocessor::preprocess(std::string_view source, std::string_view filename, const token_sink& sink, const std::filesystem::path& current_path){
+  auto saved = pimpl->state.save();
+  try{
+    pimpl->run(source, filename, sink, current_path);
+  }catch(...){
+    pimpl->state.rollback(std::move(saved));
+    throw;
+  }
+}
+
+void preprocessor::step(std::string_view text, const step_callback& callback){
+  struct restore{
+    phase4_t& s;
+    ~restore(){s.step_trace = nullptr;}
+  }_{pimpl->state};
+  pimpl->state.step_trace = callback;
+  preprocess("#pragma step " + std::string{text} + '\n', "<stdin>", {});
+}
+
+void preprocessor::write_stats_text(std::ostream& os)const{
+  pimpl->state.stats.write_text(os);
+}
+
+void preprocessor::write_stats_json(std::ostream& os)const{
+  pimpl->state.stats.write_json(os);
+}
+
+void preprocessor::write_memory_text(std::ostream& os)const{
+  pimpl->state.memory().write_text(os);
+}
+
+void preprocessor::write_memory_json(std::ostream& os)const{
+  pimpl->state.memory().write_json(os);
+}
+
+void preprocessor::tokenize(std::string_view source, std::string_view filename, const token_sink& sink){
+  const auto pass = impl::to(sink);
+  for(auto&& x : lex(std::string{source}, filename))
+    pass(x);
+}
+
+void preprocessor::enable_profiling(){
+  pimpl->state.profiler = std::make_unique<expansion_profiler>();
+}
+
+bool preprocessor::profiling()const{
+  return static_cast<bool>(pimpl->state.profiler);
+}
+
+void preprocessor::write_profile_text(std::ostream& os)const{
+  if(pimpl->state.profiler)
+    pimpl->state.profiler->write_text(os);
+}
+
+void preprocessor::write_profile_json(std::ostream& os)const{
+  if(pimpl->state.profiler)
+    pimpl->state.profiler->write_json(os);
+}
+
+}
@@ -0,0 +1,180 @@
+#include<messer/messer.hpp>
+#include<algorithm>
+#include<cerrno>
+#include<condition_variable>
+#include<cstdint>
+#include<cstring>
+#include<deque>
+#include<mutex>
+#include<optional>
+#include<sstream>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include<sys/socket.h>
+#include<sys/un.h>
+#include<unistd.h>
+
+namespace messer{
+
+namespace{
+
+bool read_all(int fd, char* buf, std::size_t size){
+  while(size){
+    const auto n = ::read(fd, buf, size);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    buf += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool write_all(int fd, const char* buf, std::size_t size){
+  while(size){
+    const auto n = ::send(fd, buf, size, MSG_NOSIGNAL);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    buf += n;
+    size -= n;
+  }
+  return true;
+}
+
+// requests declaring a larger payload close the connection
+constexpr std::size_t max_frame_size = std::size_t{64} << 20;
+
+//a frame is the size of the payload in 4 bytes big endian followed by the payload
+std::optional<std::string> read_frame(int fd){
+  unsigned char header[4];
+  if(!read_all(fd, reinterpret_cast<char*>(header), sizeof(header)))
+    return std::nullopt;
+  const std::size_t size = std::size_t{header[0]} << 24 | std::size_t{header[1]} << 16 | std::size_t{header[2]} << 8 | header[3];
+  if(size > max_frame_size)
+    return std::nullopt;
+  std::string payload(size, '\0');
+  if(!read_all(fd, payload.data(), size))
+    return std::nullopt;
+  return payload;
+}
+
+bool write_frame(int fd, std::string_view payload){
+  const auto size = static_cast<std::uint32_t>(payload.size());
+  const char header[4] = {static_cast<char>(size >> 24), static_cast<char>(size >> 16), static_cast<char>(size >> 8), static_cast<char>(size)};
+  return write_all(fd, header, sizeof(header)) && write_all(fd, payload.data(), payload.size());
+}
+
+std::string respond(const preprocessor& base, std::string_view request){
+  const auto newline = request.find('\n');
+  const auto command = request.substr(0, newline);
+  const auto body = newline == std::string_view::npos ? std::string_view{} : request.substr(newline+1);
+  std::ostringstream os;
+  std::string diagnostics;
+  try{
+    auto pp = base.snapshot();
+    pp.set_output(os);
+    pp.set_diagnostic_handler([&diagnostics](std::string_view message){
+      diagnostics.append(message).append(1, '\n');
+    });
+    if(command.substr(0, 11) == "preprocess "){
+      const std::filesystem::path path{command.substr(11)};
+      if(newline == std::string_view::npos)
+        pp.preprocess_file(path, write_to(os));
+      else
+        pp.preprocess(body, path.string(), write_to(os), path.parent_path());
+    }
+    else if(command == "expand")
+      pp.preprocess(body, "<stdin>", write_to(os));
+    else if(command == "step")
+      pp.step(body, [&os](std::string_view frame){os << frame;});
+    else
+      throw std::runtime_error("unknown request '" + std::string{command} + '\'');
+  }catch(std::exception& e){
+    return "error\n" + diagnostics + e.what();
+  }
+  //the output is incomplete when a diagnostic is raised
+  if(!diagnostics.empty())
+    return "error\n" + diagnostics;
+  return "ok\n" + os.str();
+}
+
+}
+
+void serve(const preprocessor& base, const std::filesystem::path& path, unsigned threads){
+  const auto native = path.string();
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if(native.size() >= sizeof(address.sun_path))
+    throw std::runtime_error(native + ": error: socket path is too long");
+  std::copy(native.begin(), native.end(), address.sun_path);
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(listener < 0)
+    throw std::runtime_error(native + ": error: " + std::strerror(errno));
+  struct closer{
+    int fd;
+    ~closer(){::close(fd);}
+  }_{listener};
+  std::filesystem::remove(path);
+  if(::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, SOMAXCONN) != 0)
+    throw std::runtime_error(native + ": error: " + std::strerror(errno));
+  std::mutex mutex;
+  std::condition_variable available;
+  std::deque<int> connections;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+  struct stop{
+    std::mutex& mutex;
+    std::condition_variable& available;
+    bool& stopping;
+    std::vector<std::thread>& workers;
+    ~stop(){
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+      }
+      available.notify_all();
+      for(auto&& x : workers)
+        x.join();
+    }
+  }joined{mutex, available, stopping, workers};
+  //every connection is served by one worker until the client closes it, each request on a snapshot of `base`
+  for(unsigned i = 0; i < std::max(threads, 1u); ++i)
+    workers.emplace_back([&]{
+      while(true){
+        int fd;
+        {
+          std::unique_lock<std::mutex> lock{mutex};
+          available.wait(lock, [&]{return stopping || !connections.empty();});
+          if(connections.empty())
+            return;
+          fd = connections.front();
+          connections.pop_front();
+        }
+        while(auto request = read_frame(fd))
+          if(!write_frame(fd, respond(base, *request)))
+            break;
+        ::close(fd);
+      }
+    });
+  while(true){
+    const int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if(fd < 0){
+      if(errno == EINTR || errno == ECONNABORTED)
+        continue;
+      throw std::runtime_error(native + ": error: " + std::strerror(errno));
+    }
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      connections.push_back(fd);
+    }
+    available.notify_one();
+  }
+}
+
+}